@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "Grid.h"
+#include "Rule.h"
+
+// Reproducible workload used to compare build profiles (Release, LTO, PGO, kernel clones)
+// and as the PGO training run. Every workload is deterministic: the population printed
+// next to the time must be identical for every profile.
+//
+// Usage: game_bench [input_dir] [repeat]
+//   input_dir - folder with the test patterns (default: ../input)
+//   repeat    - runs per workload, the fastest one is reported (default: 3)
+
+struct Workload {
+    std::string name;
+    std::function<int(const std::string&)> run;   // returns the final population
+};
+
+// Runs 'steps' generations of the classic rules on a pattern from the input folder
+static int runPattern(const std::string& path, int steps) {
+    Grid grid;
+    if (!grid.loadFromFile(path)) {
+        std::cerr << "Cannot load " << path << std::endl;
+        std::exit(1);
+    }
+    Game game(grid);
+    game.setSteps(steps);
+    game.setDelay(0);
+    game.run(false);
+    return game.getPopulation();
+}
+
+// Runs 'steps' generations of 'spec' on a seeded random soup
+static int runSoup(int size, double density, const std::string& spec, int steps, bool resize) {
+    Rule rule;
+    rule.parse(spec);
+    Grid grid;
+    grid.randomInit(size, size, density, 42);
+    for (int step = 0; step < steps; step++) grid.stepRule(rule, resize);
+    return grid.getPopulation();
+}
+
+int main(int argc, char** argv) {
+    std::string input = argc > 1 ? argv[1] : "../input";
+    int repeat = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+
+    std::vector<Workload> workloads = {
+        {"wikipedia",   [](const std::string& in) { return runPattern(in + "/wikipedia_test.pbm", 20000); }},
+        {"spaceship",   [](const std::string& in) { return runPattern(in + "/spaceship_test.pbm", 1500); }},
+        {"soup_b3s23",  [](const std::string&) { return runSoup(384, 0.3, "B3/S23", 200, true); }},
+        {"soup_brain",  [](const std::string&) { return runSoup(384, 0.3, "B2/S/C3", 100, false); }},
+        {"soup_bosco",  [](const std::string&) { return runSoup(384, 0.5, "R5,C0,M1,S34..58,B34..45,NM", 60, false); }},
+        {"random_init", [](const std::string&) {
+            Grid grid;
+            grid.randomInit(4096, 4096, 0.3, 42);
+            return grid.getPopulation();
+        }},
+    };
+
+    double total = 0;
+    for (const Workload& workload : workloads) {
+        double best = 0;
+        int population = 0;
+        for (int r = 0; r < repeat; r++) {
+            auto start = std::chrono::steady_clock::now();
+            population = workload.run(input);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (r == 0 || elapsed.count() < best) best = elapsed.count();
+        }
+        total += best;
+        std::cout << std::left << std::setw(12) << workload.name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << best << " ms"
+                  << "   population " << population << std::endl;
+    }
+    std::cout << std::left << std::setw(12) << "total" << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << total << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Packed rectangular bitmap of cell states, one bit per cell
+// Rows are stored one after another, each row padded to a whole number of 64-bit words;
+// bit (x % 64) of word (x / 64) of a row holds column x
+class Bitmap {
+public:
+    // Constructors
+    Bitmap();
+    Bitmap(int width, int height);
+
+    // Dimensions
+    int getWidth() const;
+    int getHeight() const;
+    int getWordsPerRow() const;
+
+    // Bit access
+    bool get(int x, int y) const;
+    void set(int x, int y, bool alive);
+
+    // Word access (a row is getWordsPerRow() words)
+    std::uint64_t* row(int y);
+    const std::uint64_t* row(int y) const;
+
+    // Number of set bits
+    int count() const;
+
+    bool operator==(const Bitmap& other) const;
+    bool operator!=(const Bitmap& other) const;
+
+private:
+    int width;
+    int height;
+    int wordsPerRow;
+    std::vector<std::uint64_t> words;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class Cell {
 public:
     // Constructors
@@ -10,13 +12,18 @@ public:
     bool isAliveNow() const;
     void setAlive(bool alive);
 
+    // Multi-state access (0 = dead, 1 = alive, 2.. = dying, for Generations rules)
+    int getState() const;
+    void setState(int state);
+
     // Next state buffer
     bool getNextState() const;
     void setNextState(bool state);
+    void setNextStateValue(int state);
     void resetNextState();
     void applyNextState();
     
 private:
-    bool isAlive;
-    bool nextState;
+    std::uint8_t state;
+    std::uint8_t nextState;
 };
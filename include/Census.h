@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+
+// Census of the objects on a (settled) grid
+// Live cells are grouped into objects when they are at most 'distance' cells apart
+// (Chebyshev distance; 2 = their neighbourhoods overlap, so both phases of toad and
+// beacon stay one object). Objects are found with a union-find over the runs of live
+// cells of each row, in parallel row bands; each object is reduced to a signature that
+// is the same under all 8 rotations / reflections and looked up in a built-in catalog
+// of common Life objects (all phases). Unknown objects are reported as
+// "unknown_<cells>_<signature>"
+class Census {
+public:
+    // Constructor (threads: 0 = one per core)
+    explicit Census(int distance = 2, int threads = 0);
+
+    // Counting
+    void take(const Grid& grid);
+
+    // Results
+    int getCount(const std::string& name) const;
+    int getObjectCount() const;
+    const std::map<std::string, int>& getCounts() const;
+
+    // Signature of a set of cells, invariant under translation, rotation and reflection
+    static std::uint64_t signature(std::vector<std::pair<int, int>> cells);
+
+private:
+    int distance;
+    int threads;
+    int objectCount;
+    std::map<std::string, int> counts;
+
+    static const std::map<std::uint64_t, std::string>& catalog();
+};
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Grid.h"
+#include "History.h"
+#include "Rule.h"
 #include <chrono>
+#include <ostream>
+#include <string>
 
 class Game {
 public:
@@ -16,15 +20,36 @@ public:
     void setSteps(int steps);
     void setDelay(int delayMs);
     void setUseAlternativeRules(bool useAlt);
+    void setRule(const Rule& r);
 
     // Simulation
     void run(bool printEachStep, bool saveFrames = false, std::string prefix = "");
 
+    // Statistics
+    int getGeneration() const;
+    int getPopulation() const;
+    int getBirths() const;
+    int getDeaths() const;
+    void setStatsFile(const std::string& path);
+
+    // History (rewind and scrubbing through past generations)
+    void setHistoryBudget(std::size_t bytes, int keyframeInterval = 64);
+    const History& getHistory() const;
+    bool rewind(int n);
+    bool seek(int gen);
+
 private:
     Grid grid;
     int stepsNumber;
     int delayMs;
     bool useAltRules;
+    bool useCustomRule;
+    Rule rule;
+    int generation;
+    std::string statsPath;
+    bool useHistory;
+    History history;
 
     void stepOnce();
+    void writeStats(std::ostream& out) const;
 };
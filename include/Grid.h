@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <deque>
 #include <string>
+#include "Bitmap.h"
 #include "Cell.h"
+#include "Rule.h"
 
 class Grid {
 public:
@@ -14,30 +17,84 @@ public:
     int getWidth() const;
     int getHeight() const;
 
-    // Cell access
+    // Cell access (local indices, 0..width-1 / 0..height-1)
     Cell& at(int x, int y);
     const Cell& at(int x, int y) const;
     bool isInside(int x, int y) const;
 
+    // World coordinates (do not change when the grid grows to the front)
+    int getOriginX() const;
+    int getOriginY() const;
+    void setOrigin(int x, int y);
+    Cell& atWorld(int x, int y);
+    const Cell& atWorld(int x, int y) const;
+    bool isInsideWorld(int x, int y) const;
+
     // File I/O
     bool loadFromFile(const std::string& path);
     bool saveToFile(const std::string& path) const;
 
     // Initialization
     void randomInit(int width, int height, int p = 20);
+    void randomInit(int width, int height, double density, std::uint64_t seed, int threads = 0);
 
     // Simulation steps
     void stepClassicRules(bool resize = true);
     void stepAlternativeRules(bool resize = true);
+    void stepRule(const Rule& rule, bool resize = true);
+    void stepLargerThanLife(const Rule& rule, bool resize = true, int threads = 0);
 
     // Output
     void print() const;
 
+    // Region access in world coordinates (stable when the grid grows to the front)
+    enum class PatchMode { Copy, Or, Xor };
+    Bitmap extractRegion(int x, int y, int w, int h) const;
+    void applyPatch(const Bitmap& patch, int x, int y, PatchMode mode = PatchMode::Copy);
+    int countAliveInRegion(int x, int y, int w, int h) const;
+    template <typename Callback>
+    void forEachAliveInRegion(int x, int y, int w, int h, Callback callback) const;
+
+    // Statistics (kept up to date by load, init, patches and the step kernels)
+    int getPopulation() const;
+    int getBirths() const;
+    int getDeaths() const;
+    bool getBoundingBox(int& minX, int& minY, int& maxX, int& maxY) const;
+
 private:
     int width;
     int height;
     std::deque<std::deque<Cell>> cells;
 
+    // world coordinates of the cell stored at cells[0][0]
+    int originX;
+    int originY;
+
+    int population;
+    int births;
+    int deaths;
+    int bboxMinX, bboxMinY, bboxMaxX, bboxMaxY;
+    bool statsDirty;   // cells were edited through at() / atWorld() since the last scan
+
     int countAliveNeighbors(int x, int y) const;
     void resizeIfNeeded();
+    void applyNextStates();
+    void recomputeStats();
+    bool clipRegion(int& x0, int& y0, int& x1, int& y1) const;
+    void growToInclude(int minX, int minY, int maxX, int maxY);
+    void ensureMargin(int margin);
 };
+
+// Calls callback(x, y) with the world coordinates of every live cell inside the
+// w x h rectangle starting at world position (x, y), column by column
+template <typename Callback>
+void Grid::forEachAliveInRegion(int x, int y, int w, int h, Callback callback) const {
+    int x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+    if (!clipRegion(x0, y0, x1, y1)) return;
+    for (int lx = x0; lx < x1; lx++) {
+        auto it = cells[lx].begin() + y0;
+        for (int ly = y0; ly < y1; ly++, ++it) {
+            if (it->isAliveNow()) callback(lx + originX, ly + originY);
+        }
+    }
+}
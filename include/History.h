@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "Bitmap.h"
+#include "Grid.h"
+
+// In-memory history of consecutive generations for rewinding and scrubbing
+// Every 'keyframeInterval' generations a full frame (keyframe) is stored, the generations
+// in between only store the cells that flipped since the previous one (delta); both are
+// compressed as varint-coded gaps between set bits (dense keyframes as raw bits). When the memory budget is exceeded
+// the oldest keyframe together with its deltas is dropped
+// Cell states are stored as bit planes (plane p holds bit p of every state), so the dying
+// states of Generations rules are restored too; two-state grids only need one plane
+class History {
+public:
+    // Constructors
+    History();
+    explicit History(std::size_t memoryBudget, int keyframeInterval = 64);
+
+    // Configuration
+    void setMemoryBudget(std::size_t bytes);
+    void setKeyframeInterval(int interval);
+    void clear();
+
+    // Recording (generations must be consecutive, otherwise the history restarts)
+    void record(int generation, const Grid& grid);
+    void truncateAfter(int generation);
+
+    // Queries
+    bool empty() const;
+    bool contains(int generation) const;
+    int getOldestGeneration() const;
+    int getNewestGeneration() const;
+    std::size_t getMemoryUsage() const;
+
+    // Reconstruction
+    bool restore(int generation, Grid& grid) const;
+
+private:
+    struct Frame {
+        int originX, originY;   // world position and size of the grid in this generation
+        int width, height;
+        bool keyframe;
+        std::vector<std::vector<std::uint8_t>> planes;   // encoded data of each bit plane
+    };
+
+    std::size_t memoryBudget;
+    int keyframeInterval;
+    std::deque<Frame> frames;
+    int firstGeneration;
+    int lastKeyframeGeneration;
+    std::size_t memoryUsage;
+
+    // newest recorded generation, used to compute the next delta
+    std::vector<Bitmap> lastPlanes;
+    int lastOriginX, lastOriginY;
+
+    static std::size_t frameSize(const Frame& frame);
+    void evict();
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+// GOL_KERNEL marks the definitions of the hot simulation loops. When the project is
+// configured with GOL_KERNEL_CLONES=ON, each marked function is compiled once per
+// instruction set (AVX2, SSE4.2 and the baseline) and the best variant for the running
+// CPU is picked by the dynamic loader (GNU ifunc); otherwise the macro expands to nothing
+// Only put it on definitions, so the variants and their resolver live in a single file
+#if defined(GOL_KERNEL_CLONES) && defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define GOL_KERNEL __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+#define GOL_KERNEL
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Splits [0, count) into one contiguous band per thread and calls fn(begin, end) for
+// each band, using the calling thread for the first one (threads <= 0: one per core)
+template <typename Fn>
+void parallelFor(int count, int threads, Fn fn) {
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads <= 0) threads = 1;
+    if (threads > count) threads = count > 0 ? count : 1;
+
+    std::vector<std::thread> workers;
+    int band = (count + threads - 1) / threads;
+    for (int t = 1; t < threads; t++) {
+        int begin = t * band;
+        int end = std::min(count, begin + band);
+        if (begin < end) workers.emplace_back(fn, begin, end);
+    }
+    fn(0, std::min(count, band));
+    for (std::thread& worker : workers) worker.join();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Outer-totalistic rule, optionally with extra dying states (Generations family)
+// Accepted notations:
+//  - "B3/S23"           Life-like rule (birth / survival neighbour counts)
+//  - "B2/S/C3"          Generations rule with 3 states (Brian's Brain)
+//  - "345/2/4"          Generations rule in S/B/C notation (Star Wars)
+//  - "R5,C0,M1,S34..58,B34..45,NM"
+//                       Larger than Life rule (Bosco's rule): range R, states C
+//                       (0 or 2 for two states), M1 to count the middle cell,
+//                       survival / birth count ranges, NM Moore or NN von Neumann
+class Rule {
+public:
+    enum class Neighborhood { Moore, VonNeumann };
+
+    // Constructors (default: Conway's B3/S23)
+    Rule();
+
+    // Parsing
+    bool parse(const std::string& spec);
+    std::string toString() const;
+
+    // Queries
+    bool isBirth(int neighbors) const;
+    bool isSurvival(int neighbors) const;
+    int getStates() const;
+
+    // Larger than Life queries
+    bool isLargerThanLife() const;
+    int getRange() const;
+    Neighborhood getNeighborhood() const;
+    bool includesCenter() const;
+
+private:
+    std::uint32_t birthMask;     // bit n set: a dead cell with n live neighbours is born
+    std::uint32_t survivalMask;  // bit n set: a live cell with n live neighbours survives
+    int states;                  // 2 for Life-like rules, > 2 for Generations rules
+
+    // Larger than Life: counts are checked against [min, max] ranges instead of the masks
+    bool largerThanLife;
+    int range;
+    Neighborhood neighborhood;
+    bool countCenter;
+    int birthMin, birthMax;
+    int survivalMin, survivalMax;
+
+    bool parseLargerThanLife(const std::string& spec);
+};
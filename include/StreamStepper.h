@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include "Bitmap.h"
+#include "Rule.h"
+
+// Out-of-core stepping of boards too large to keep in memory
+// The board is read from a binary PBM (P4) file as a stream of row strips and the
+// result is written to a new P4 file. Only three input strips plus halo rows are resident
+// (the current strip, the next one, the one after them being read asynchronously, and the
+// halo rows kept from the previous strip), next to the working copies of the current strip
+// with its halos and the previous result being written asynchronously. Each pass advances
+// several generations at once (temporal blocking): the current strip is stepped together
+// with 'generationsPerPass' halo rows on each side, which absorb the error of not seeing
+// the rest of the board. The board has a fixed size, cells outside it are dead
+class StreamStepper {
+public:
+    // Constructor (default: B3/S23, 256-row strips, 8 generations per pass)
+    StreamStepper();
+
+    // Settings
+    bool setRule(const Rule& rule);
+    void setStripHeight(int rows);
+    void setGenerationsPerPass(int generations);
+
+    // Stepping
+    bool run(const std::string& inputPath, const std::string& outputPath, int generations);
+
+private:
+    bool birth[9];
+    bool survival[9];
+    int stripHeight;
+    int generationsPerPass;
+
+    bool runPass(const std::string& inputPath, const std::string& outputPath, int generations) const;
+    Bitmap stepWindow(const Bitmap& previous, const Bitmap& current, const Bitmap& next, int generations) const;
+    void stepBitmap(const Bitmap& source, Bitmap& target) const;
+};
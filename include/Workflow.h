@@ -14,8 +14,9 @@ private:
     void showMenu();
     bool askLoadFromFile();
     std::string askFilePath();
-    void askRandomGridParams(int& w, int& h, int& p);
+    void askRandomGridParams(int& w, int& h, double& p);
     void askStepsAndDelay(int& steps, int& delayMs);
+    void askRule();
     bool askSaveFinal();
     std::string askOutputFilePath();
 
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Builds every build profile and runs the benchmark workload (bench/game_bench.cpp)
+# with each of them, so that the gain of LTO, PGO and the kernel clones can be compared
+#
+# Usage: scripts/bench_profiles.sh [output_dir]
+#   output_dir - where the profile builds go (default: _profiles in the repository)
+#   REPEAT=n   - runs per workload, the fastest one is reported (default: 3)
+set -euo pipefail
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${1:-$ROOT/_profiles}
+REPEAT=${REPEAT:-3}
+JOBS=$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 2)
+
+# build <name> <cmake options...>
+build() {
+    local name=$1
+    shift
+    echo "== building $name" >&2
+    cmake -S "$ROOT" -B "$OUT/$name" -DCMAKE_BUILD_TYPE=Release -DGOL_BUILD_TESTS=OFF \
+          -DCMAKE_RUNTIME_OUTPUT_DIRECTORY="$OUT/$name/bin" "$@" > /dev/null
+    cmake --build "$OUT/$name" -j"$JOBS" --target game_bench > /dev/null
+}
+
+build release     -DGOL_ENABLE_LTO=OFF -DGOL_PGO=OFF -DGOL_KERNEL_CLONES=OFF
+build release-lto -DGOL_ENABLE_LTO=ON  -DGOL_PGO=OFF -DGOL_KERNEL_CLONES=OFF
+build clones      -DGOL_ENABLE_LTO=OFF -DGOL_PGO=OFF -DGOL_KERNEL_CLONES=ON
+
+# two-stage PGO in one build directory: instrument, train, rebuild with the profile
+rm -rf "$OUT/pgo/pgo-profiles"
+build pgo -DGOL_ENABLE_LTO=ON -DGOL_PGO=GENERATE -DGOL_KERNEL_CLONES=OFF
+echo "== training pgo" >&2
+"$OUT/pgo/bin/game_bench" "$ROOT/input" 1 > /dev/null
+if ls "$OUT/pgo/pgo-profiles"/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -o "$OUT/pgo/pgo-profiles/default.profdata" "$OUT/pgo/pgo-profiles"/*.profraw
+fi
+build pgo -DGOL_ENABLE_LTO=ON -DGOL_PGO=USE -DGOL_KERNEL_CLONES=OFF
+
+baseline=""
+for name in release release-lto clones pgo; do
+    echo
+    echo "== $name"
+    "$OUT/$name/bin/game_bench" "$ROOT/input" "$REPEAT" | tee "$OUT/$name/bench.txt"
+    total=$(awk '$1 == "total" { print $2 }' "$OUT/$name/bench.txt")
+    if [ -z "$baseline" ]; then baseline=$total; fi
+    awk -v b="$baseline" -v t="$total" 'BEGIN { printf "speedup vs release: %.2fx\n", b / t }'
+done
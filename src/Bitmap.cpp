@@ -0,0 +1,51 @@
+#include "Bitmap.h"
+#include "Kernels.h"
+
+// Default constructor: creates an empty bitmap
+Bitmap::Bitmap() : width(0), height(0), wordsPerRow(0) {}
+
+// Constructor: creates a width x height bitmap with all bits cleared
+Bitmap::Bitmap(int w, int h)
+    : width(w), height(h), wordsPerRow((w + 63) / 64),
+      words(static_cast<std::size_t>(wordsPerRow) * h, 0) {}
+
+// Returns the width of the bitmap in cells
+int Bitmap::getWidth() const { return width; }
+
+// Returns the height of the bitmap in cells
+int Bitmap::getHeight() const { return height; }
+
+// Returns the number of 64-bit words used per row
+int Bitmap::getWordsPerRow() const { return wordsPerRow; }
+
+// Returns the bit at (x, y)
+bool Bitmap::get(int x, int y) const {
+    return (words[static_cast<std::size_t>(y) * wordsPerRow + x / 64] >> (x % 64)) & 1u;
+}
+
+// Sets the bit at (x, y) to 'alive'
+void Bitmap::set(int x, int y, bool alive) {
+    std::uint64_t& word = words[static_cast<std::size_t>(y) * wordsPerRow + x / 64];
+    std::uint64_t mask = std::uint64_t(1) << (x % 64);
+    if (alive) word |= mask;
+    else word &= ~mask;
+}
+
+// Returns a pointer to the first word of row y
+std::uint64_t* Bitmap::row(int y) { return words.data() + static_cast<std::size_t>(y) * wordsPerRow; }
+const std::uint64_t* Bitmap::row(int y) const { return words.data() + static_cast<std::size_t>(y) * wordsPerRow; }
+
+// Returns the number of set bits (padding bits are always zero)
+GOL_KERNEL
+int Bitmap::count() const {
+    int total = 0;
+    for (std::uint64_t word : words) total += __builtin_popcountll(word);
+    return total;
+}
+
+// Two bitmaps are equal if they have the same size and the same bits
+bool Bitmap::operator==(const Bitmap& other) const {
+    return width == other.width && height == other.height && words == other.words;
+}
+
+bool Bitmap::operator!=(const Bitmap& other) const { return !(*this == other); }
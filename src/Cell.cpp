@@ -1,43 +1,61 @@
 #include "Cell.h"
 
 // Default constructor initializes the cell as dead with nextState false
-Cell::Cell() : isAlive(false), nextState(false) {}
+Cell::Cell() : state(0), nextState(0) {}
 
 // Constructor initializes the cell with the given alive state and nextState false
 // Parameters: alive - initial alive state of the cell
-Cell::Cell(bool alive) : isAlive(alive), nextState(false) {}
+Cell::Cell(bool alive) : state(alive ? 1 : 0), nextState(0) {}
 
 // Returns whether the cell is currently alive
 // Returns: true if the cell is alive, false otherwise
 bool Cell::isAliveNow() const {
-    return isAlive;
+    return state == 1;
 }
 
 // Sets the current alive state of the cell
 // Parameters: alive - the new alive state to set
 void Cell::setAlive(bool alive) {
-    isAlive = alive;
+    state = alive ? 1 : 0;
+}
+
+// Returns the current state of the cell: 0 dead, 1 alive, 2 and above dying
+// (only used by Generations rules)
+int Cell::getState() const {
+    return state;
+}
+
+// Sets the current state of the cell
+// Parameters: s - the new state (0-255)
+void Cell::setState(int s) {
+    state = static_cast<std::uint8_t>(s);
 }
 
 // Returns the next state of the cell (to be applied in the next update)
 // Returns: true if the cell will be alive in the next state, false otherwise
 bool Cell::getNextState() const {
-    return nextState;
+    return nextState == 1;
 }
 
 // Sets the next state of the cell
-// Parameters: state - the next state to set for the cell
-void Cell::setNextState(bool state) {
-    nextState = state;
+// Parameters: alive - the next state to set for the cell
+void Cell::setNextState(bool alive) {
+    nextState = alive ? 1 : 0;
+}
+
+// Sets the next state of the cell as a multi-state value
+// Parameters: s - the next state (0-255)
+void Cell::setNextStateValue(int s) {
+    nextState = static_cast<std::uint8_t>(s);
 }
 
 // Resets the next state to false (dead)
 void Cell::resetNextState() {
-    nextState = false;
+    nextState = 0;
 }
 
 // Applies the next state to the current state and resets nextState to false
 void Cell::applyNextState() {
-    isAlive = nextState;
-    nextState = false;
+    state = nextState;
+    nextState = 0;
 }
@@ -0,0 +1,260 @@
+#include "Census.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "Parallel.h"
+
+// Constructor with the grouping distance and the number of threads (0 = one per core)
+Census::Census(int d, int t) : distance(std::max(d, 1)), threads(t), objectCount(0) {}
+
+// A horizontal run of live cells [x0, x1] in one row
+struct Run {
+    int x0;
+    int x1;
+};
+
+// Union-find root with path halving
+static int findRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Merges the sets of a and b; the smaller index becomes the root so the result does
+// not depend on the order of the unions
+static void unite(std::vector<int>& parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a;
+    else parent[a] = b;
+}
+
+// Finds the runs of set bits of every row of 'bits'; runs of row y are
+// runs[rowStart[y] .. rowStart[y + 1])
+static void findRuns(const Bitmap& bits, std::vector<Run>& runs, std::vector<int>& rowStart) {
+    rowStart.assign(bits.getHeight() + 1, 0);
+    for (int y = 0; y < bits.getHeight(); y++) {
+        rowStart[y] = static_cast<int>(runs.size());
+        const std::uint64_t* row = bits.row(y);
+        for (int word = 0; word < bits.getWordsPerRow(); word++) {
+            std::uint64_t w = row[word];
+            while (w != 0) {
+                int start = __builtin_ctzll(w);
+                std::uint64_t ones = ~(w >> start);
+                int length = ones == 0 ? 64 - start : __builtin_ctzll(ones);
+                int x0 = word * 64 + start;
+                int x1 = x0 + length - 1;
+                if (runs.size() > static_cast<std::size_t>(rowStart[y]) && runs.back().x1 == x0 - 1) {
+                    runs.back().x1 = x1;   // continues a run from the previous word
+                } else {
+                    runs.push_back({x0, x1});
+                }
+                w = start + length >= 64 ? 0 : w & (~std::uint64_t(0) << (start + length));
+            }
+        }
+    }
+    rowStart[bits.getHeight()] = static_cast<int>(runs.size());
+}
+
+// Unites the runs of rows ya and yb that come within 'd' cells of each other
+static void uniteRows(const std::vector<Run>& runs, const std::vector<int>& rowStart,
+                      std::vector<int>& parent, int ya, int yb, int d) {
+    int i = rowStart[ya], iEnd = rowStart[ya + 1];
+    int j = rowStart[yb], jEnd = rowStart[yb + 1];
+    while (i < iEnd && j < jEnd) {
+        const Run& a = runs[i];
+        const Run& b = runs[j];
+        if (a.x1 + d < b.x0) {
+            i++;
+        } else if (b.x1 + d < a.x0) {
+            j++;
+        } else {
+            unite(parent, i, j);
+            if (a.x1 < b.x1) i++;
+            else j++;
+        }
+    }
+}
+
+// Counts the objects of 'grid'
+void Census::take(const Grid& grid) {
+    counts.clear();
+    objectCount = 0;
+
+    Bitmap bits = grid.extractRegion(grid.getOriginX(), grid.getOriginY(), grid.getWidth(), grid.getHeight());
+    std::vector<Run> runs;
+    std::vector<int> rowStart;
+    findRuns(bits, runs, rowStart);
+    if (runs.empty()) return;
+
+    std::vector<int> parent(runs.size());
+    for (std::size_t i = 0; i < parent.size(); i++) parent[i] = static_cast<int>(i);
+
+    // unite within row bands in parallel (each band only touches its own runs),
+    // then across the band borders
+    const int height = bits.getHeight();
+    std::vector<char> bandStart(height, 0);
+    parallelFor(height, threads, [&](int y0, int y1) {
+        bandStart[y0] = 1;
+        for (int y = y0; y < y1; y++) {
+            for (int i = rowStart[y] + 1; i < rowStart[y + 1]; i++) {
+                if (runs[i].x0 - runs[i - 1].x1 <= distance) unite(parent, i - 1, i);
+            }
+            for (int dy = 1; dy <= distance && y + dy < y1; dy++) {
+                uniteRows(runs, rowStart, parent, y, y + dy, distance);
+            }
+        }
+    });
+    for (int border = 1; border < height; border++) {
+        if (!bandStart[border]) continue;
+        for (int y = std::max(0, border - distance); y < border; y++) {
+            for (int yb = border; yb <= y + distance && yb < height; yb++) {
+                uniteRows(runs, rowStart, parent, y, yb, distance);
+            }
+        }
+    }
+
+    // collect the cells of every object
+    std::vector<int> objectOf(runs.size(), -1);
+    std::vector<std::vector<std::pair<int, int>>> objects;
+    for (int y = 0; y < height; y++) {
+        for (int i = rowStart[y]; i < rowStart[y + 1]; i++) {
+            int root = findRoot(parent, i);
+            if (objectOf[root] < 0) {
+                objectOf[root] = static_cast<int>(objects.size());
+                objects.emplace_back();
+            }
+            std::vector<std::pair<int, int>>& cells = objects[objectOf[root]];
+            for (int x = runs[i].x0; x <= runs[i].x1; x++) cells.emplace_back(x, y);
+        }
+    }
+
+    const std::map<std::uint64_t, std::string>& known = catalog();
+    for (std::vector<std::pair<int, int>>& cells : objects) {
+        std::size_t size = cells.size();
+        std::uint64_t sig = signature(std::move(cells));
+        auto it = known.find(sig);
+        if (it != known.end()) {
+            counts[it->second]++;
+        } else {
+            std::ostringstream name;
+            name << "unknown_" << size << "_" << std::hex << std::setw(16) << std::setfill('0') << sig;
+            counts[name.str()]++;
+        }
+        objectCount++;
+    }
+}
+
+// Returns how many objects called 'name' were found
+int Census::getCount(const std::string& name) const {
+    auto it = counts.find(name);
+    return it == counts.end() ? 0 : it->second;
+}
+
+// Returns the total number of objects found
+int Census::getObjectCount() const { return objectCount; }
+
+// Returns the number of objects per name
+const std::map<std::string, int>& Census::getCounts() const { return counts; }
+
+// Computes the canonical form of the cells (the smallest sorted cell list among the
+// 8 rotations / reflections, moved to the origin) and hashes it with FNV-1a
+std::uint64_t Census::signature(std::vector<std::pair<int, int>> cells) {
+    std::vector<std::pair<int, int>> best, candidate(cells.size());
+    for (int t = 0; t < 8; t++) {
+        int minX = 0, minY = 0;
+        for (std::size_t i = 0; i < cells.size(); i++) {
+            int x = cells[i].first, y = cells[i].second;
+            if (t & 4) std::swap(x, y);
+            if (t & 1) x = -x;
+            if (t & 2) y = -y;
+            candidate[i] = {y, x};   // sort by row first
+            if (i == 0 || x < minX) minX = x;
+            if (i == 0 || y < minY) minY = y;
+        }
+        for (std::pair<int, int>& cell : candidate) {
+            cell.first -= minY;
+            cell.second -= minX;
+        }
+        std::sort(candidate.begin(), candidate.end());
+        if (t == 0 || candidate < best) best = candidate;
+    }
+
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](std::uint32_t value) {
+        for (int byte = 0; byte < 4; byte++) {
+            hash ^= (value >> (8 * byte)) & 0xFF;
+            hash *= 0x100000001B3ULL;
+        }
+    };
+    mix(static_cast<std::uint32_t>(best.size()));
+    for (const std::pair<int, int>& cell : best) {
+        mix(static_cast<std::uint32_t>(cell.first));
+        mix(static_cast<std::uint32_t>(cell.second));
+    }
+    return hash;
+}
+
+// Built-in catalog: signature of every phase of common Life objects -> name
+// Phases are generated by running each pattern with the classic rules for one period
+const std::map<std::uint64_t, std::string>& Census::catalog() {
+    static const std::map<std::uint64_t, std::string> table = [] {
+        struct Entry {
+            const char* name;
+            int period;
+            const char* rows;   // 'o' alive, '.' dead, rows separated by '/'
+        };
+        const Entry entries[] = {
+            {"block", 1, "oo/oo"},
+            {"beehive", 1, ".oo./o..o/.oo."},
+            {"loaf", 1, ".oo./o..o/.o.o/..o."},
+            {"boat", 1, "oo./o.o/.o."},
+            {"ship", 1, "oo./o.o/.oo"},
+            {"tub", 1, ".o./o.o/.o."},
+            {"pond", 1, ".oo./o..o/o..o/.oo."},
+            {"long boat", 1, "oo../o.o./.o.o/..o."},
+            {"barge", 1, ".o../o.o./.o.o/..o."},
+            {"snake", 1, "oo.o/o.oo"},
+            {"aircraft carrier", 1, "oo../o..o/..oo"},
+            {"eater 1", 1, "oo../o.o./..o./..oo"},
+            {"blinker", 2, "ooo"},
+            {"toad", 2, ".ooo/ooo."},
+            {"beacon", 2, "oo../oo../..oo/..oo"},
+            {"pulsar", 3, "..ooo...ooo../............./o....o.o....o/o....o.o....o/o....o.o....o/"
+                          "..ooo...ooo../............./..ooo...ooo../o....o.o....o/o....o.o....o/"
+                          "o....o.o....o/............./..ooo...ooo.."},
+            {"glider", 4, ".o./..o/ooo"},
+            {"lwss", 4, ".o..o/o..../o...o/oooo."},
+            {"mwss", 4, "...o../.o...o/o...../o....o/ooooo."},
+            {"hwss", 4, "...oo../.o....o/o....../o.....o/oooooo."},
+        };
+
+        std::map<std::uint64_t, std::string> result;
+        for (const Entry& entry : entries) {
+            std::vector<std::string> rows;
+            std::stringstream stream(entry.rows);
+            std::string row;
+            while (std::getline(stream, row, '/')) rows.push_back(row);
+
+            const int margin = 4;
+            Grid grid(static_cast<int>(rows[0].size()) + 2 * margin, static_cast<int>(rows.size()) + 2 * margin);
+            for (std::size_t y = 0; y < rows.size(); y++) {
+                for (std::size_t x = 0; x < rows[y].size(); x++) {
+                    if (rows[y][x] == 'o') grid.at(static_cast<int>(x) + margin, static_cast<int>(y) + margin).setAlive(true);
+                }
+            }
+            for (int phase = 0; phase < entry.period; phase++) {
+                std::vector<std::pair<int, int>> cells;
+                grid.forEachAliveInRegion(0, 0, grid.getWidth(), grid.getHeight(),
+                                          [&cells](int x, int y) { cells.emplace_back(x, y); });
+                result[signature(std::move(cells))] = entry.name;
+                grid.stepClassicRules(false);
+            }
+        }
+        return result;
+    }();
+    return table;
+}
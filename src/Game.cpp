@@ -2,17 +2,18 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <fstream>
 
 // Default constructor initializes stepsNumber, delay, and rule mode
-Game::Game() : stepsNumber(30), delayMs(100), useAltRules(false) {}
+Game::Game() : stepsNumber(30), delayMs(100), useAltRules(false), useCustomRule(false), generation(0), useHistory(false) {}
 
 // Constructor initializes the grid and default parameters
 // Parameters: initialGrid - the initial state of the grid
-Game::Game(const Grid& initialGrid) : grid(initialGrid), stepsNumber(30), delayMs(100), useAltRules(false) {}
+Game::Game(const Grid& initialGrid) : grid(initialGrid), stepsNumber(30), delayMs(100), useAltRules(false), useCustomRule(false), generation(0), useHistory(false) {}
 
-// Sets the game grid to g
+// Sets the game grid to g and restarts the generation count
 // Parameters: g - the new grid to set
-void Game::setGrid(const Grid& g) { grid = g; }
+void Game::setGrid(const Grid& g) { grid = g; generation = 0; history.clear(); }
 
 // Returns a reference to the game grid
 // Returns: reference to the grid
@@ -32,13 +33,25 @@ void Game::setDelay(int delayMs_) { delayMs = delayMs_; }
 
 // Sets whether to use alternative rules
 // Parameters: useAlt - true to use alternative rules, false for classic
-void Game::setUseAlternativeRules(bool useAlt) { useAltRules = useAlt; }
+void Game::setUseAlternativeRules(bool useAlt) { useAltRules = useAlt; useCustomRule = false; }
+
+// Sets a custom rule (Life-like or Generations) to use instead of the built-in rule sets
+// Parameters: r - the rule to apply at each step
+void Game::setRule(const Rule& r) { rule = r; useCustomRule = true; }
 
 // Runs the game for the specified number of steps
 // Parameters: printEachStep - if true, prints the grid at each step
-//             saveFrames - if true, saves each frame to a PBM file
+//             saveFrames - if true, saves each frame to a PBM file (PGM for multi-state rules)
 //             prefix - prefix for saved frame filenames
 void Game::run(bool printEachStep, bool saveFrames, std::string prefix) {
+    std::ofstream stats;
+    if (!statsPath.empty()) {
+        stats.open(statsPath, std::ios::app);
+        if (stats.is_open() && stats.tellp() == 0) {
+            stats << "generation,population,births,deaths,minX,minY,maxX,maxY\n";
+        }
+    }
+
     for (int step = 0; step <= stepsNumber; step++) {
         if (printEachStep) {
             system("clear");
@@ -47,10 +60,13 @@ void Game::run(bool printEachStep, bool saveFrames, std::string prefix) {
         }
 
         if (saveFrames) {
-            std::string filename = "../output/" + prefix + "_" + std::to_string(step) + ".pbm";
+            std::string extension = (useCustomRule && rule.getStates() > 2) ? ".pgm" : ".pbm";
+            std::string filename = "../output/" + prefix + "_" + std::to_string(step) + extension;
             grid.saveToFile(filename);
         }
 
+        if (stats.is_open()) writeStats(stats);
+
         if (step == stepsNumber) break;
         
         std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
@@ -59,10 +75,75 @@ void Game::run(bool printEachStep, bool saveFrames, std::string prefix) {
 }
 
 // Advances the game by one step using the selected rules
+// With the history enabled, both the current and the new generation are recorded;
+// generations after the current one (left over from a rewind) are discarded first
 void Game::stepOnce() {
-    if (useAltRules) {
+    if (useHistory) {
+        history.truncateAfter(generation);
+        if (!history.contains(generation)) history.record(generation, grid);
+    }
+    if (useCustomRule) {
+        grid.stepRule(rule);
+    } else if (useAltRules) {
         grid.stepAlternativeRules();
     } else {
         grid.stepClassicRules();
     }
+    generation++;
+    if (useHistory) history.record(generation, grid);
+}
+
+// Returns the number of generations simulated since the grid was set
+int Game::getGeneration() const { return generation; }
+
+// Returns the number of live cells in the current generation
+int Game::getPopulation() const { return grid.getPopulation(); }
+
+// Returns the number of cells born in the last generation
+int Game::getBirths() const { return grid.getBirths(); }
+
+// Returns the number of cells that died in the last generation
+int Game::getDeaths() const { return grid.getDeaths(); }
+
+// Sets the CSV file that receives one line of statistics per generation during run()
+// Parameters: path - output file (appended to), empty string disables the output
+void Game::setStatsFile(const std::string& path) { statsPath = path; }
+
+// Enables the in-memory history of past generations (0 bytes disables it)
+// Parameters: bytes - memory budget, the oldest generations are dropped beyond it
+//             keyframeInterval - generations between two full frames
+void Game::setHistoryBudget(std::size_t bytes, int keyframeInterval) {
+    useHistory = bytes > 0;
+    history.setKeyframeInterval(keyframeInterval);
+    history.setMemoryBudget(bytes);
+    if (!useHistory) history.clear();
+}
+
+// Returns the recorded history
+const History& Game::getHistory() const { return history; }
+
+// Goes back n generations
+// Returns false (and keeps the current grid) if that generation is no longer recorded
+bool Game::rewind(int n) { return seek(generation - n); }
+
+// Replaces the grid with the recorded generation 'gen'
+// Returns false (and keeps the current grid) if that generation is not recorded
+bool Game::seek(int gen) {
+    if (!history.restore(gen, grid)) return false;
+    generation = gen;
+    return true;
+}
+
+// Writes the statistics of the current generation as one CSV line
+// The bounding box columns are left empty if there are no live cells
+void Game::writeStats(std::ostream& out) const {
+    out << generation << "," << grid.getPopulation() << ","
+        << grid.getBirths() << "," << grid.getDeaths() << ",";
+    int minX, minY, maxX, maxY;
+    if (grid.getBoundingBox(minX, minY, maxX, maxY)) {
+        out << minX << "," << minY << "," << maxX << "," << maxY;
+    } else {
+        out << ",,,";
+    }
+    out << "\n";
 }
@@ -1,16 +1,26 @@
 #include "Grid.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cstdlib>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
 #include <deque>
 #include <string>
+#include <vector>
 #include "Cell.h"
+#include "Kernels.h"
+#include "Parallel.h"
 
 // Default constructor: creates an empty grid
-Grid::Grid() : width(0), height(0) {}
+Grid::Grid() : width(0), height(0), originX(0), originY(0), population(0), births(0), deaths(0),
+               bboxMinX(0), bboxMinY(0), bboxMaxX(-1), bboxMaxY(-1), statsDirty(false) {}
 
 // Constructor: initializes a grid of given width (w) and height (h) with dead cells
-Grid::Grid(int w, int h) : width(w), height(h), cells(w, std::deque<Cell>(h)) {}
+Grid::Grid(int w, int h) : width(w), height(h), cells(w, std::deque<Cell>(h)),
+                           originX(0), originY(0), population(0), births(0), deaths(0),
+                           bboxMinX(0), bboxMinY(0), bboxMaxX(-1), bboxMaxY(-1), statsDirty(false) {}
 
 // Returns the current width of the grid
 int Grid::getWidth() const { return width; }
@@ -19,76 +29,211 @@ int Grid::getWidth() const { return width; }
 int Grid::getHeight() const { return height; }
 
 // Returns a reference to the cell at position (x, y)
-Cell& Grid::at(int x, int y) { return cells[x][y]; }
+// The cell may be edited through it, so the statistics are rescanned before the next patch
+Cell& Grid::at(int x, int y) {
+    statsDirty = true;
+    return cells[x][y];
+}
 const Cell& Grid::at(int x, int y) const { return cells[x][y]; }
 
 // Checks if coordinates (x, y) are inside the grid boundaries
 bool Grid::isInside(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
 
+// Returns the world x coordinate of the cell at local index 0
+int Grid::getOriginX() const { return originX; }
+
+// Returns the world y coordinate of the cell at local index 0
+int Grid::getOriginY() const { return originY; }
+
+// Moves the grid in world coordinates: local cell (0, 0) gets world position (x, y)
+void Grid::setOrigin(int x, int y) {
+    originX = x;
+    originY = y;
+}
+
+// Returns a reference to the cell at world position (x, y)
+Cell& Grid::atWorld(int x, int y) {
+    statsDirty = true;
+    return cells[x - originX][y - originY];
+}
+const Cell& Grid::atWorld(int x, int y) const { return cells[x - originX][y - originY]; }
+
+// Checks if world coordinates (x, y) are inside the grid boundaries
+bool Grid::isInsideWorld(int x, int y) const { return isInside(x - originX, y - originY); }
+
+// Skips PBM comment lines ('#' to end of line); a comment of the form
+// "# origin X Y" sets the world coordinates of the first cell
+static void skipComments(std::istream& file, int& originX, int& originY) {
+    while (file >> std::ws && file.peek() == '#') {
+        std::string line;
+        std::getline(file, line);
+        std::istringstream comment(line.substr(1));
+        std::string key;
+        int x, y;
+        if (comment >> key >> x >> y && key == "origin") {
+            originX = x;
+            originY = y;
+        }
+    }
+}
+
 // Loads grid size and cell states from a PBM file at 'path'
+// A PGM file (P2) is read as a multi-state grid: each grey level is a cell state
+// A binary PBM file (P4, rows of MSB-first bytes) is accepted as well
 // Returns true if successful, false otherwise
 bool Grid::loadFromFile(const std::string& path) {
-    std::ifstream file(path);
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) return false;
 
     std::string magic;
     file >> magic;
     
-    // Strict PBM check
-    if (magic != "P1") {
+    // Strict PBM (P1 or P4) or PGM (P2, one grey level per cell state) check
+    if (magic != "P1" && magic != "P2" && magic != "P4") {
         return false; 
     }
+    bool multiState = magic == "P2";
+    bool binary = magic == "P4";
     
-    file >> width >> height;
+    originX = 0;
+    originY = 0;
+    skipComments(file, originX, originY);
+    file >> width;
+    skipComments(file, originX, originY);
+    file >> height;
+    int maxState = 1;
+    if (multiState) {
+        skipComments(file, originX, originY);
+        file >> maxState;
+    }
     cells.assign(width, std::deque<Cell>(height)); // Resize & Clear
 
+    if (binary) {
+        file.get(); // single whitespace before the raster
+        std::vector<char> bytes((width + 7) / 8);
+        for (int y = 0; y < height; y++) {
+            if (!file.read(bytes.data(), bytes.size())) return false;
+            for (int x = 0; x < width; x++) {
+                cells[x][y].setAlive((bytes[x / 8] >> (7 - x % 8)) & 1);
+            }
+        }
+        births = 0;
+        deaths = 0;
+        recomputeStats();
+        return true;
+    }
+
     int val;
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             file >> val;
-            cells[x][y].setAlive(val == 1);
+            if (multiState) cells[x][y].setState(val < 0 ? 0 : (val > maxState ? maxState : val));
+            else cells[x][y].setAlive(val == 1);
             cells[x][y].resetNextState();
         }
     }
+    births = 0;
+    deaths = 0;
+    recomputeStats();
     return true;
 }
 
 
 // Randomly initializes a grid of width w, height h, with probability p (0-100) of cells being alive
+// The seed is taken from the current time, use the overload below for reproducible grids
 void Grid::randomInit(int w, int h, int p) {
-    srand (time(NULL));
-    
-    width = w;
-    height = h;
-
     if(p < 0 || p > 100) p = 20; // default probability if out of range
+    randomInit(w, h, p / 100.0, static_cast<std::uint64_t>(time(NULL)));
+}
 
-    cells.resize(width, std::deque<Cell>(height));
+// SplitMix64 output function: maps a counter to a well mixed 64-bit value
+static std::uint64_t splitMix64(std::uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-    for(int y = 0; y < height; y++){
-        for(int x = 0; x < width; x++){
-            int randNum = rand() % 100;
-            cells[x][y].setAlive(randNum < p);
-            cells[x][y].resetNextState();
-        }
+// Returns 64 independent random bits, each set with probability 'threshold' / 2^32
+// The word is fully determined by (seed, counter); the threshold bits are consumed
+// from the least significant one: a set bit ORs in a fresh random word, a clear bit ANDs
+static std::uint64_t bernoulliWord(std::uint64_t seed, std::uint64_t counter, std::uint32_t threshold) {
+    std::uint64_t key = splitMix64(seed ^ splitMix64(counter));
+    std::uint64_t word = 0;
+    int first = 0;
+    while (first < 32 && !((threshold >> first) & 1u)) first++; // trailing zero bits have no effect
+    for (int bit = first; bit < 32; bit++) {
+        std::uint64_t r = splitMix64(key + static_cast<std::uint64_t>(bit));
+        word = ((threshold >> bit) & 1u) ? (word | r) : (word & r);
     }
+    return word;
+}
+
+// Randomly initializes a grid of width w and height h where each cell is alive with
+// probability 'density' (0.0-1.0), using a counter-based generator seeded with 'seed'
+// Cells are generated in blocks of 64 per column; each block only depends on the seed
+// and its position, so columns can be filled in parallel with an identical result for
+// any number of threads (0 = one per hardware thread)
+void Grid::randomInit(int w, int h, double density, std::uint64_t seed, int threads) {
+    width = w;
+    height = h;
+    cells.assign(width, std::deque<Cell>(height));
+    originX = 0;
+    originY = 0;
+
+    if (!(density > 0.0)) density = 0.0;   // also catches NaN
+    bool allAlive = density >= 1.0;
+    std::uint32_t threshold = allAlive ? 0 : static_cast<std::uint32_t>(density * 4294967296.0);
+
+    parallelFor(width, threads, [&](int xBegin, int xEnd) {
+        for (int x = xBegin; x < xEnd; x++) {
+            std::deque<Cell>& column = cells[x];
+            for (int yWord = 0; yWord * 64 < height; yWord++) {
+                std::uint64_t counter = (static_cast<std::uint64_t>(x) << 32) | static_cast<std::uint32_t>(yWord);
+                std::uint64_t word = allAlive ? ~0ULL : bernoulliWord(seed, counter, threshold);
+                int yEnd = std::min(height, yWord * 64 + 64);
+                for (int y = yWord * 64; y < yEnd; y++, word >>= 1) {
+                    column[y].setAlive(word & 1u);
+                }
+            }
+        }
+    });
+
+    births = 0;
+    deaths = 0;
+    recomputeStats();
 }
 
 
 // Saves the current grid state to a text file at 'path'. Returns true if successful
+// The world origin is stored as a "# origin X Y" comment so it survives a reload
+// Paths ending in ".pgm" are written as PGM (P2) with the cell states as grey levels,
+// so the dying states of Generations rules are kept; everything else is written as PBM
 bool Grid::saveToFile(const std::string& path) const {
     std::string filename = path;
 
-    if (filename.find(".pbm") == std::string::npos) filename += ".pbm";
+    bool multiState = filename.size() >= 4 && filename.substr(filename.size() - 4) == ".pgm";
+    if (!multiState && filename.find(".pbm") == std::string::npos) filename += ".pbm";
 
     std::ofstream file(filename);
     if (!file.is_open()) return false;
 
-    file << "P1\n" << width << " " << height << "\n";
+    int maxState = 1;
+    if (multiState) {
+        for (const std::deque<Cell>& column : cells) {
+            for (const Cell& cell : column) maxState = std::max(maxState, cell.getState());
+        }
+    }
+
+    file << (multiState ? "P2\n" : "P1\n");
+    file << "# origin " << originX << " " << originY << "\n";
+    file << width << " " << height << "\n";
+    if (multiState) file << maxState << "\n";
 
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            file << (cells[x][y].isAliveNow() ? "1 " : "0 ");
+            if (multiState) file << cells[x][y].getState() << " ";
+            else file << (cells[x][y].isAliveNow() ? "1 " : "0 ");
         }
         file << "\n";
     }
@@ -103,6 +248,7 @@ bool Grid::saveToFile(const std::string& path) const {
 //  2) Any live cell with two or three live neighbours lives on to the next generation
 //  3) Any live cell with more than three live neighbours dies
 //  4) Any dead cell with exactly three live neighbours becomes a live cell
+GOL_KERNEL
 void Grid::stepClassicRules(bool resize) {
     //calculateNextState() code
 
@@ -132,11 +278,7 @@ void Grid::stepClassicRules(bool resize) {
     if(resize) resizeIfNeeded();
 
     //apply changes
-    for(int y = 0; y < height; y++){
-        for(int x = 0; x < width; x++){
-            cells[x][y].applyNextState();
-        }
-    }
+    applyNextStates();
 }
 
 // Placeholder for alternative rules;
@@ -144,6 +286,7 @@ void Grid::stepClassicRules(bool resize) {
 //  2) Any live cell with two or four live neighbours lives on to the next generation
 //  3) Any live cell with three live neighbours or more than four dies
 //  4) Any dead cell with exactly three or four live neighbours becomes a live cell
+GOL_KERNEL
 void Grid::stepAlternativeRules(bool resize) {
     // Too boring to implement
     // Determine next state for each cell
@@ -172,11 +315,173 @@ void Grid::stepAlternativeRules(bool resize) {
     if(resize) resizeIfNeeded();
 
     //apply changes
-    for(int y = 0; y < height; y++){
-        for(int x = 0; x < width; x++){
-            cells[x][y].applyNextState();
+    applyNextStates();
+}
+
+// Applies an arbitrary outer-totalistic rule (Life-like or Generations) to each cell
+// 'resize' indicates whether the grid should expand if alive cells reach boundaries
+// Rules (only live cells, state 1, are counted as neighbours):
+//  1) A dead cell (state 0) becomes alive if its neighbour count is a birth count
+//  2) A live cell stays alive if its neighbour count is a survival count, otherwise it
+//     starts dying (state 2), or dies directly for two-state rules
+//  3) A dying cell advances one state per step and is dead after the last state
+GOL_KERNEL
+void Grid::stepRule(const Rule& rule, bool resize) {
+    if (rule.isLargerThanLife()) {
+        stepLargerThanLife(rule, resize);
+        return;
+    }
+    const int states = rule.getStates();
+
+    // Determine next state for each cell
+    for(int x = 0; x < width; x++){
+        std::deque<Cell>& column = cells[x];
+        for(int y = 0; y < height; y++){
+            Cell& cell = column[y];
+            int state = cell.getState();
+            if(state == 0){
+                cell.setNextStateValue(rule.isBirth(countAliveNeighbors(x, y)) ? 1 : 0);
+            } else if(state == 1){
+                if(rule.isSurvival(countAliveNeighbors(x, y))) cell.setNextStateValue(1);
+                else cell.setNextStateValue(states > 2 ? 2 : 0);
+            } else {
+                cell.setNextStateValue(state + 1 < states ? state + 1 : 0);
+            }
         }
     }
+
+    // resize grid if needed (infinity grid)
+    if(resize) resizeIfNeeded();
+
+    //apply changes
+    applyNextStates();
+}
+
+// Applies a Larger than Life rule (range R, Moore or von Neumann neighbourhood) to each cell
+// 'resize' grows the grid beforehand so that live cells are at least R cells from every
+// edge, otherwise births within reach of a live cell could fall outside the grid
+// Neighbour counts cost O(1) per cell for any R:
+//  - Moore: box query on a summed-area table
+//  - von Neumann: the diamond is slid along each row, adding and removing the four
+//    diagonal edges with prefix sums along both diagonal directions
+// Tables use unsigned 32-bit arithmetic: differences are exact even if partial sums wrap
+// The next states are computed in parallel row bands ('threads' <= 0: one per core)
+void Grid::stepLargerThanLife(const Rule& rule, bool resize, int threads) {
+    const int r = rule.getRange();
+    const int states = rule.getStates();
+    const bool vonNeumann = rule.getNeighborhood() == Rule::Neighborhood::VonNeumann;
+    const int excludeCenter = rule.includesCenter() ? 0 : 1;
+
+    if (resize) ensureMargin(r);
+    if (width == 0 || height == 0) return;
+
+    // summed-area table, column-major: sat[x * (height + 1) + y] = live cells in [0, x) x [0, y)
+    const int satHeight = height + 1;
+    std::vector<std::uint32_t> sat(static_cast<std::size_t>(width + 1) * satHeight, 0);
+    parallelFor(width, threads, [&](int xBegin, int xEnd) {
+        for (int x = xBegin; x < xEnd; x++) {
+            std::uint32_t* column = &sat[static_cast<std::size_t>(x + 1) * satHeight];
+            int y = 0;
+            for (const Cell& cell : cells[x]) {
+                column[y + 1] = column[y] + cell.isAliveNow();
+                y++;
+            }
+        }
+    });
+    parallelFor(satHeight, threads, [&](int yBegin, int yEnd) {
+        for (int x = 1; x <= width; x++) {
+            std::uint32_t* column = &sat[static_cast<std::size_t>(x) * satHeight];
+            const std::uint32_t* previous = column - satHeight;
+            for (int y = yBegin; y < yEnd; y++) column[y] += previous[y];
+        }
+    });
+    auto boxCount = [&](int x0, int y0, int x1, int y1) -> int {   // [x0, x1) x [y0, y1), clipped
+        x0 = std::max(x0, 0);  y0 = std::max(y0, 0);
+        x1 = std::min(x1, width);  y1 = std::min(y1, height);
+        if (x0 >= x1 || y0 >= y1) return 0;
+        const std::uint32_t* a = &sat[static_cast<std::size_t>(x0) * satHeight];
+        const std::uint32_t* b = &sat[static_cast<std::size_t>(x1) * satHeight];
+        return static_cast<int>(b[y1] - b[y0] - a[y1] + a[y0]);
+    };
+
+    // diagonal prefix sums: down[i, j] sums cells (i - k, j - k), up[i, j] sums cells (i - k, j + k)
+    std::vector<std::uint32_t> down, up;
+    if (vonNeumann) {
+        down.assign(static_cast<std::size_t>(width) * height, 0);
+        up.assign(static_cast<std::size_t>(width) * height, 0);
+        for (int x = 0; x < width; x++) {
+            std::uint32_t* downColumn = &down[static_cast<std::size_t>(x) * height];
+            std::uint32_t* upColumn = &up[static_cast<std::size_t>(x) * height];
+            int y = 0;
+            for (const Cell& cell : cells[x]) {
+                std::uint32_t alive = cell.isAliveNow();
+                downColumn[y] = alive + ((x > 0 && y > 0) ? downColumn[y - 1 - height] : 0);
+                upColumn[y] = alive + ((x > 0 && y < height - 1) ? upColumn[y + 1 - height] : 0);
+                y++;
+            }
+        }
+    }
+    // sum of 'length' cells from (x, y) in direction (1, 1), clipped to the grid
+    auto downSegment = [&](int x, int y, int length) -> int {
+        int k0 = std::max({0, -x, -y});
+        int k1 = std::min({length - 1, width - 1 - x, height - 1 - y});
+        if (k0 > k1) return 0;
+        std::uint32_t end = down[static_cast<std::size_t>(x + k1) * height + (y + k1)];
+        int bx = x + k0 - 1, by = y + k0 - 1;
+        std::uint32_t before = (bx >= 0 && by >= 0) ? down[static_cast<std::size_t>(bx) * height + by] : 0;
+        return static_cast<int>(end - before);
+    };
+    // sum of 'length' cells from (x, y) in direction (1, -1), clipped to the grid
+    auto upSegment = [&](int x, int y, int length) -> int {
+        int k0 = std::max({0, -x, y - (height - 1)});
+        int k1 = std::min({length - 1, width - 1 - x, y});
+        if (k0 > k1) return 0;
+        std::uint32_t end = up[static_cast<std::size_t>(x + k1) * height + (y - k1)];
+        int bx = x + k0 - 1, by = y - k0 + 1;
+        std::uint32_t before = (bx >= 0 && by < height) ? up[static_cast<std::size_t>(bx) * height + by] : 0;
+        return static_cast<int>(end - before);
+    };
+
+    // Determine next state for each cell
+    parallelFor(height, threads, [&](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            int diamond = 0;
+            if (vonNeumann) {
+                // diamond around (0, y), one row segment at a time
+                for (int dy = -r; dy <= r; dy++) {
+                    int half = r - std::abs(dy);
+                    diamond += boxCount(-half, y + dy, half + 1, y + dy + 1);
+                }
+            }
+            for (int x = 0; x < width; x++) {
+                Cell& cell = cells[x][y];
+                int state = cell.getState();
+                int count = 0;
+                if (state <= 1) {
+                    count = vonNeumann ? diamond : boxCount(x - r, y - r, x + r + 1, y + r + 1);
+                    count -= excludeCenter * state;
+                }
+
+                if (state == 0) {
+                    cell.setNextStateValue(rule.isBirth(count) ? 1 : 0);
+                } else if (state == 1) {
+                    if (rule.isSurvival(count)) cell.setNextStateValue(1);
+                    else cell.setNextStateValue(states > 2 ? 2 : 0);
+                } else {
+                    cell.setNextStateValue(state + 1 < states ? state + 1 : 0);
+                }
+
+                if (vonNeumann) {
+                    // slide the diamond from x to x + 1
+                    diamond += downSegment(x + 1, y - r, r + 1) + upSegment(x + 1, y + r, r)
+                             - upSegment(x - r, y, r + 1) - downSegment(x - r + 1, y + 1, r);
+                }
+            }
+        }
+    });
+
+    //apply changes
+    applyNextStates();
 }
 
 // Prints a horizontal line of length l
@@ -185,13 +490,14 @@ void drawLine(int l){
     std::cout << '\n';
 }
 
-// Prints the current grid to the console, live cells as '█', dead as space
+// Prints the current grid to the console, live cells as '█', dying as '░', dead as space
 void Grid::print() const {
     // printBoard() code
     drawLine(width);
     for(int y = 0; y < height; y++){
         for(int x = 0; x < width; x++){
             if (cells[x][y].isAliveNow()) std::cout << "█";
+            else if (cells[x][y].getState() > 1) std::cout << "░";
             else std::cout << " ";
         }
         std::cout << std::endl;
@@ -223,6 +529,7 @@ void Grid::resizeIfNeeded() {
                 cells[xCol].push_front(Cell());
             }
             height++;
+            originY--;
             break;
         }
     }
@@ -243,6 +550,7 @@ void Grid::resizeIfNeeded() {
         if (cells[0][y].isAliveNow()) {
             cells.push_front(std::deque<Cell>(height));
             width++;
+            originX--;
             break;
         }
     }
@@ -255,4 +563,255 @@ void Grid::resizeIfNeeded() {
             break;
         }
     }
+}
+
+// Applies the buffered next state of every cell and updates the statistics
+// (population, births, deaths, bounding box) in the same pass
+GOL_KERNEL
+void Grid::applyNextStates() {
+    statsDirty = false;
+    population = 0;
+    births = 0;
+    deaths = 0;
+    bboxMinX = width;  bboxMinY = height;
+    bboxMaxX = -1;     bboxMaxY = -1;
+
+    // iterate column by column to follow the storage order
+    for (int x = 0; x < width; x++) {
+        std::deque<Cell>& column = cells[x];
+        int colMinY = height, colMaxY = -1;
+        for (int y = 0; y < height; y++) {
+            Cell& cell = column[y];
+            bool wasAlive = cell.isAliveNow();
+            cell.applyNextState();
+            bool alive = cell.isAliveNow();
+
+            births += (!wasAlive && alive);
+            deaths += (wasAlive && !alive);
+            if (alive) {
+                population++;
+                if (colMinY > y) colMinY = y;
+                colMaxY = y;
+            }
+        }
+        if (colMaxY >= 0) {
+            if (bboxMinX > x) bboxMinX = x;
+            bboxMaxX = x;
+            if (bboxMinY > colMinY) bboxMinY = colMinY;
+            if (bboxMaxY < colMaxY) bboxMaxY = colMaxY;
+        }
+    }
+}
+
+// Recomputes population and bounding box from scratch (used after load / init / patch)
+GOL_KERNEL
+void Grid::recomputeStats() {
+    statsDirty = false;
+    population = 0;
+    bboxMinX = width;  bboxMinY = height;
+    bboxMaxX = -1;     bboxMaxY = -1;
+    for (int x = 0; x < width; x++) {
+        int colMinY = height, colMaxY = -1;
+        int y = 0;
+        for (const Cell& cell : cells[x]) {
+            if (cell.isAliveNow()) {
+                population++;
+                if (colMinY > y) colMinY = y;
+                colMaxY = y;
+            }
+            y++;
+        }
+        if (colMaxY >= 0) {
+            if (bboxMinX > x) bboxMinX = x;
+            bboxMaxX = x;
+            if (bboxMinY > colMinY) bboxMinY = colMinY;
+            if (bboxMaxY < colMaxY) bboxMaxY = colMaxY;
+        }
+    }
+}
+
+// Returns the number of live cells
+int Grid::getPopulation() const { return population; }
+
+// Returns the number of cells born in the last step
+int Grid::getBirths() const { return births; }
+
+// Returns the number of cells that died in the last step
+int Grid::getDeaths() const { return deaths; }
+
+// Writes the bounding box of the live cells to (minX, minY) - (maxX, maxY), inclusive,
+// in world coordinates
+// Returns false (and leaves the parameters untouched) if there are no live cells
+bool Grid::getBoundingBox(int& minX, int& minY, int& maxX, int& maxY) const {
+    if (population == 0) return false;
+    minX = bboxMinX + originX;
+    minY = bboxMinY + originY;
+    maxX = bboxMaxX + originX;
+    maxY = bboxMaxY + originY;
+    return true;
+}
+
+// Grows the grid so that every live cell is at least 'margin' cells away from each edge
+void Grid::ensureMargin(int margin) {
+    recomputeStats();
+    if (population == 0) return;
+    growToInclude(bboxMinX + originX - margin, bboxMinY + originY - margin,
+                  bboxMaxX + originX + margin, bboxMaxY + originY + margin);
+}
+
+// Clips the world rectangle [x0, x1) x [y0, y1) to the grid and converts it to local indices
+// Returns false if the rectangle does not overlap the grid
+bool Grid::clipRegion(int& x0, int& y0, int& x1, int& y1) const {
+    x0 = std::max(x0 - originX, 0);
+    y0 = std::max(y0 - originY, 0);
+    x1 = std::min(x1 - originX, width);
+    y1 = std::min(y1 - originY, height);
+    return x0 < x1 && y0 < y1;
+}
+
+// Grows the grid (adding dead rows/columns on any side) until it contains the
+// inclusive world rectangle (minX, minY) - (maxX, maxY); the origin is adjusted so
+// that existing cells keep their world coordinates
+void Grid::growToInclude(int minX, int minY, int maxX, int maxY) {
+    if (width == 0 || height == 0) {
+        originX = minX;
+        originY = minY;
+        width = maxX - minX + 1;
+        height = maxY - minY + 1;
+        cells.assign(width, std::deque<Cell>(height));
+        return;
+    }
+
+    int addTop = std::max(originY - minY, 0);
+    int addBottom = std::max(maxY - (originY + height - 1), 0);
+    if (addTop > 0 || addBottom > 0) {
+        for (std::deque<Cell>& column : cells) {
+            column.insert(column.begin(), addTop, Cell());
+            column.insert(column.end(), addBottom, Cell());
+        }
+        height += addTop + addBottom;
+        originY -= addTop;
+    }
+
+    int addLeft = std::max(originX - minX, 0);
+    int addRight = std::max(maxX - (originX + width - 1), 0);
+    if (addLeft > 0 || addRight > 0) {
+        cells.insert(cells.begin(), addLeft, std::deque<Cell>(height));
+        cells.insert(cells.end(), addRight, std::deque<Cell>(height));
+        width += addLeft + addRight;
+        originX -= addLeft;
+    }
+
+    // local bounding box indices moved with the origin
+    bboxMinX += addLeft;  bboxMaxX += addLeft;
+    bboxMinY += addTop;   bboxMaxY += addTop;
+}
+
+// Returns the cells of the w x h rectangle starting at world position (x, y) as a bitmap
+// Cells outside the grid are dead
+GOL_KERNEL
+Bitmap Grid::extractRegion(int x, int y, int w, int h) const {
+    Bitmap region(std::max(w, 0), std::max(h, 0));
+    int x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+    if (!clipRegion(x0, y0, x1, y1)) return region;
+
+    for (int lx = x0; lx < x1; lx++) {
+        int bx = lx + originX - x;
+        std::uint64_t mask = std::uint64_t(1) << (bx % 64);
+        int word = bx / 64;
+        auto it = cells[lx].begin() + y0;
+        for (int ly = y0; ly < y1; ly++, ++it) {
+            if (it->isAliveNow()) region.row(ly + originY - y)[word] |= mask;
+        }
+    }
+    return region;
+}
+
+// Writes 'patch' into the grid with its top-left corner at world position (x, y)
+// Copy replaces the covered cells, Or sets the live cells of the patch, Xor toggles them
+// The grid grows if live patch cells fall outside of it
+void Grid::applyPatch(const Bitmap& patch, int x, int y, PatchMode mode) {
+    if (statsDirty) recomputeStats();
+
+    // bounding box of the live patch cells, found word by word
+    int minX = patch.getWidth(), minY = patch.getHeight(), maxX = -1, maxY = -1;
+    for (int py = 0; py < patch.getHeight(); py++) {
+        const std::uint64_t* row = patch.row(py);
+        for (int word = 0; word < patch.getWordsPerRow(); word++) {
+            if (row[word] == 0) continue;
+            minX = std::min(minX, word * 64 + __builtin_ctzll(row[word]));
+            maxX = std::max(maxX, word * 64 + 63 - __builtin_clzll(row[word]));
+            if (minY > py) minY = py;
+            maxY = py;
+        }
+    }
+    if (maxX >= 0) growToInclude(x + minX, y + minY, x + maxX, y + maxY);
+
+    int x0 = x, y0 = y, x1 = x + patch.getWidth(), y1 = y + patch.getHeight();
+    if (!clipRegion(x0, y0, x1, y1)) return;
+
+    // statistics follow the cells actually written: births grow the bounding box, only
+    // a death on its edge needs a rescan
+    bool wasEmpty = population == 0;
+    bool edgeCleared = false;
+    int bornMinX = width, bornMinY = height, bornMaxX = -1, bornMaxY = -1;
+    auto write = [&](int lx, int ly, bool alive) {
+        Cell& cell = cells[lx][ly];
+        bool wasAlive = cell.isAliveNow();
+        cell.setAlive(alive);
+        if (wasAlive == alive) return;
+        if (alive) {
+            population++;
+            bornMinX = std::min(bornMinX, lx);  bornMaxX = std::max(bornMaxX, lx);
+            bornMinY = std::min(bornMinY, ly);  bornMaxY = std::max(bornMaxY, ly);
+        } else {
+            population--;
+            edgeCleared |= lx == bboxMinX || lx == bboxMaxX || ly == bboxMinY || ly == bboxMaxY;
+        }
+    };
+
+    for (int ly = y0; ly < y1; ly++) {
+        const std::uint64_t* row = patch.row(ly + originY - y);
+        for (int word = 0; word < patch.getWordsPerRow(); word++) {
+            std::uint64_t bits = row[word];
+            if (mode != PatchMode::Copy) {
+                // only the set bits matter: visit them one by one
+                while (bits != 0) {
+                    int lx = word * 64 + __builtin_ctzll(bits) + x - originX;
+                    bits &= bits - 1;
+                    write(lx, ly, mode == PatchMode::Or || !cells[lx][ly].isAliveNow());
+                }
+                continue;
+            }
+            int lxBegin = std::max(word * 64 + x - originX, x0);
+            int lxEnd = std::min(word * 64 + 64 + x - originX, x1);
+            for (int lx = lxBegin; lx < lxEnd; lx++) {
+                write(lx, ly, (bits >> (lx - x + originX - word * 64)) & 1u);
+            }
+        }
+    }
+
+    if (edgeCleared) {
+        recomputeStats();
+    } else if (bornMaxX >= 0 && wasEmpty) {
+        bboxMinX = bornMinX;  bboxMinY = bornMinY;
+        bboxMaxX = bornMaxX;  bboxMaxY = bornMaxY;
+    } else if (bornMaxX >= 0) {
+        bboxMinX = std::min(bboxMinX, bornMinX);  bboxMinY = std::min(bboxMinY, bornMinY);
+        bboxMaxX = std::max(bboxMaxX, bornMaxX);  bboxMaxY = std::max(bboxMaxY, bornMaxY);
+    }
+}
+
+// Returns the number of live cells in the w x h rectangle starting at world position (x, y)
+GOL_KERNEL
+int Grid::countAliveInRegion(int x, int y, int w, int h) const {
+    int x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+    if (!clipRegion(x0, y0, x1, y1)) return 0;
+
+    int count = 0;
+    for (int lx = x0; lx < x1; lx++) {
+        auto it = cells[lx].begin() + y0;
+        for (int ly = y0; ly < y1; ly++, ++it) count += it->isAliveNow();
+    }
+    return count;
 }
\ No newline at end of file
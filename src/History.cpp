@@ -0,0 +1,344 @@
+#include "History.h"
+#include <algorithm>
+
+// Default constructor: 256 MB budget, one keyframe every 64 generations
+History::History() : History(std::size_t(256) << 20) {}
+
+// Constructor with a memory budget in bytes and the distance between keyframes
+History::History(std::size_t budget, int interval)
+    : memoryBudget(budget), keyframeInterval(std::max(interval, 1)), firstGeneration(0),
+      lastKeyframeGeneration(0), memoryUsage(0), lastOriginX(0), lastOriginY(0) {}
+
+// Sets the memory budget in bytes; old generations are dropped to stay below it
+void History::setMemoryBudget(std::size_t bytes) {
+    memoryBudget = bytes;
+    evict();
+}
+
+// Sets the number of generations between two keyframes (applies to new frames)
+void History::setKeyframeInterval(int interval) { keyframeInterval = std::max(interval, 1); }
+
+// Removes all recorded generations
+void History::clear() {
+    frames.clear();
+    memoryUsage = 0;
+    lastPlanes.clear();
+}
+
+// Appends an unsigned LEB128 varint to 'out'
+static void writeVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Reads an unsigned LEB128 varint from data at 'pos' and advances 'pos'
+static std::uint64_t readVarint(const std::vector<std::uint8_t>& data, std::size_t& pos) {
+    std::uint64_t value = 0;
+    int shift = 0;
+    while (pos < data.size()) {
+        std::uint8_t byte = data[pos++];
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    return value;
+}
+
+// Encodes the set bits of 'bits' (row-major) as varint gaps between their linear indices
+static void encodeBits(const Bitmap& bits, std::vector<std::uint8_t>& out) {
+    std::uint64_t next = 0;   // first index not yet covered by a gap
+    for (int y = 0; y < bits.getHeight(); y++) {
+        const std::uint64_t* row = bits.row(y);
+        for (int word = 0; word < bits.getWordsPerRow(); word++) {
+            std::uint64_t w = row[word];
+            while (w != 0) {
+                std::uint64_t index = static_cast<std::uint64_t>(y) * bits.getWidth()
+                                    + word * 64 + __builtin_ctzll(w);
+                writeVarint(out, index - next);
+                next = index + 1;
+                w &= w - 1;
+            }
+        }
+    }
+}
+
+// Toggles the bits listed in 'data' from byte 'pos' on (as written by encodeBits) in 'bits'
+static void decodeBitsXor(const std::vector<std::uint8_t>& data, std::size_t pos, Bitmap& bits) {
+    std::uint64_t next = 0;
+    const std::uint64_t width = static_cast<std::uint64_t>(bits.getWidth());
+    while (pos < data.size()) {
+        std::uint64_t index = next + readVarint(data, pos);
+        next = index + 1;
+        int x = static_cast<int>(index % width);
+        int y = static_cast<int>(index / width);
+        bits.row(y)[x / 64] ^= std::uint64_t(1) << (x % 64);
+    }
+}
+
+// Encodes a keyframe: a leading 0 byte followed by the gaps (see encodeBits), or a
+// leading 1 byte followed by the raw words if that is smaller (dense grids)
+static void encodeKeyframe(const Bitmap& bits, std::vector<std::uint8_t>& out) {
+    out.push_back(0);
+    encodeBits(bits, out);
+    std::size_t rawSize = 1 + static_cast<std::size_t>(bits.getWordsPerRow()) * bits.getHeight() * 8;
+    if (out.size() <= rawSize) return;
+
+    out.assign(1, 1);
+    for (int y = 0; y < bits.getHeight(); y++) {
+        const std::uint64_t* row = bits.row(y);
+        for (int word = 0; word < bits.getWordsPerRow(); word++) {
+            for (int byte = 0; byte < 8; byte++) out.push_back(static_cast<std::uint8_t>(row[word] >> (8 * byte)));
+        }
+    }
+}
+
+// Decodes a keyframe written by encodeKeyframe into 'bits' (which must be cleared)
+static void decodeKeyframe(const std::vector<std::uint8_t>& data, Bitmap& bits) {
+    if (data.empty()) return;
+    if (data[0] == 0) {
+        decodeBitsXor(data, 1, bits);
+        return;
+    }
+    std::size_t pos = 1;
+    for (int y = 0; y < bits.getHeight(); y++) {
+        std::uint64_t* row = bits.row(y);
+        for (int word = 0; word < bits.getWordsPerRow(); word++) {
+            std::uint64_t value = 0;
+            for (int byte = 0; byte < 8; byte++) value |= static_cast<std::uint64_t>(data[pos++]) << (8 * byte);
+            row[word] = value;
+        }
+    }
+}
+
+// Returns a w x h bitmap with the set bits of 'src' moved by (dx, dy); bits that land
+// outside are dropped
+static Bitmap place(const Bitmap& src, int dx, int dy, int w, int h) {
+    if (dx == 0 && dy == 0 && w == src.getWidth() && h == src.getHeight()) return src;
+    Bitmap result(w, h);
+    for (int y = 0; y < src.getHeight(); y++) {
+        int ty = y + dy;
+        if (ty < 0 || ty >= h) continue;
+        const std::uint64_t* row = src.row(y);
+        for (int word = 0; word < src.getWordsPerRow(); word++) {
+            std::uint64_t bitsLeft = row[word];
+            while (bitsLeft != 0) {
+                int tx = word * 64 + __builtin_ctzll(bitsLeft) + dx;
+                bitsLeft &= bitsLeft - 1;
+                if (tx >= 0 && tx < w) result.row(ty)[tx / 64] |= std::uint64_t(1) << (tx % 64);
+            }
+        }
+    }
+    return result;
+}
+
+// Splits the cell states of 'grid' into bit planes: plane p holds bit p of every state
+// (a single plane, the live cells, for two-state grids)
+static std::vector<Bitmap> extractPlanes(const Grid& grid) {
+    int maxState = 1;
+    for (int x = 0; x < grid.getWidth(); x++) {
+        for (int y = 0; y < grid.getHeight(); y++) maxState = std::max(maxState, grid.at(x, y).getState());
+    }
+    if (maxState == 1) return {grid.extractRegion(grid.getOriginX(), grid.getOriginY(), grid.getWidth(), grid.getHeight())};
+
+    int count = 0;
+    while (maxState >> count) count++;
+    std::vector<Bitmap> planes(count, Bitmap(grid.getWidth(), grid.getHeight()));
+    for (int x = 0; x < grid.getWidth(); x++) {
+        for (int y = 0; y < grid.getHeight(); y++) {
+            int state = grid.at(x, y).getState();
+            for (int p = 0; state >> p; p++) {
+                if ((state >> p) & 1) planes[p].row(y)[x / 64] |= std::uint64_t(1) << (x % 64);
+            }
+        }
+    }
+    return planes;
+}
+
+// Bytes used by a frame, including its bookkeeping
+std::size_t History::frameSize(const Frame& frame) {
+    std::size_t size = sizeof(Frame) + frame.planes.capacity() * sizeof(std::vector<std::uint8_t>);
+    for (const std::vector<std::uint8_t>& plane : frame.planes) size += plane.capacity();
+    return size;
+}
+
+// Records the state of 'grid' as 'generation'
+// If the generation does not directly follow the newest recorded one, the history restarts
+void History::record(int generation, const Grid& grid) {
+    if (!frames.empty() && generation != getNewestGeneration() + 1) clear();
+
+    Frame frame;
+    frame.originX = grid.getOriginX();
+    frame.originY = grid.getOriginY();
+    frame.width = grid.getWidth();
+    frame.height = grid.getHeight();
+    frame.keyframe = frames.empty() || generation - lastKeyframeGeneration >= keyframeInterval;
+
+    std::vector<Bitmap> planes = extractPlanes(grid);
+    if (frame.keyframe) {
+        frame.planes.resize(planes.size());
+        for (std::size_t p = 0; p < planes.size(); p++) encodeKeyframe(planes[p], frame.planes[p]);
+        lastKeyframeGeneration = generation;
+    } else {
+        // flipped cells over the union of the previous and the current grid area,
+        // for every plane of either generation
+        const int lastWidth = lastPlanes[0].getWidth(), lastHeight = lastPlanes[0].getHeight();
+        int x0 = std::min(lastOriginX, frame.originX);
+        int y0 = std::min(lastOriginY, frame.originY);
+        int x1 = std::max(lastOriginX + lastWidth, frame.originX + frame.width);
+        int y1 = std::max(lastOriginY + lastHeight, frame.originY + frame.height);
+        frame.planes.resize(std::max(planes.size(), lastPlanes.size()));
+        for (std::size_t p = 0; p < frame.planes.size(); p++) {
+            Bitmap flips = place(p < lastPlanes.size() ? lastPlanes[p] : Bitmap(lastWidth, lastHeight),
+                                 lastOriginX - x0, lastOriginY - y0, x1 - x0, y1 - y0);
+            Bitmap current = place(p < planes.size() ? planes[p] : Bitmap(frame.width, frame.height),
+                                   frame.originX - x0, frame.originY - y0, x1 - x0, y1 - y0);
+            for (int y = 0; y < flips.getHeight(); y++) {
+                std::uint64_t* row = flips.row(y);
+                const std::uint64_t* other = current.row(y);
+                for (int word = 0; word < flips.getWordsPerRow(); word++) row[word] ^= other[word];
+            }
+            encodeBits(flips, frame.planes[p]);
+        }
+    }
+    for (std::vector<std::uint8_t>& plane : frame.planes) plane.shrink_to_fit();
+    frame.planes.shrink_to_fit();
+
+    if (frames.empty()) firstGeneration = generation;
+    memoryUsage += frameSize(frame);
+    frames.push_back(std::move(frame));
+    lastPlanes = std::move(planes);
+    lastOriginX = grid.getOriginX();
+    lastOriginY = grid.getOriginY();
+
+    evict();
+}
+
+// Drops every recorded generation after 'generation' (used when the simulation
+// continues from a rewound state)
+void History::truncateAfter(int generation) {
+    if (frames.empty() || generation >= getNewestGeneration()) return;
+    if (generation < firstGeneration) {
+        clear();
+        return;
+    }
+    while (getNewestGeneration() > generation) {
+        memoryUsage -= frameSize(frames.back());
+        frames.pop_back();
+    }
+    for (int g = getNewestGeneration(); g >= firstGeneration; g--) {
+        if (frames[g - firstGeneration].keyframe) {
+            lastKeyframeGeneration = g;
+            break;
+        }
+    }
+
+    // the newest frame becomes the reference for the next delta
+    Grid newest;
+    restore(getNewestGeneration(), newest);
+    lastOriginX = newest.getOriginX();
+    lastOriginY = newest.getOriginY();
+    lastPlanes = extractPlanes(newest);
+}
+
+// Drops the oldest keyframe with its deltas until the memory budget is met
+// (the newest keyframe group is always kept)
+void History::evict() {
+    while (memoryUsage > memoryBudget && !frames.empty()) {
+        std::size_t next = 1;
+        while (next < frames.size() && !frames[next].keyframe) next++;
+        if (next == frames.size()) break;
+        for (std::size_t i = 0; i < next; i++) {
+            memoryUsage -= frameSize(frames.front());
+            frames.pop_front();
+        }
+        firstGeneration += static_cast<int>(next);
+    }
+}
+
+// Returns true if no generation is recorded
+bool History::empty() const { return frames.empty(); }
+
+// Returns true if 'generation' can be restored
+bool History::contains(int generation) const {
+    return !frames.empty() && generation >= firstGeneration && generation <= getNewestGeneration();
+}
+
+// Returns the oldest generation that can be restored
+int History::getOldestGeneration() const { return firstGeneration; }
+
+// Returns the newest recorded generation
+int History::getNewestGeneration() const { return firstGeneration + static_cast<int>(frames.size()) - 1; }
+
+// Returns the number of bytes used by the recorded frames
+std::size_t History::getMemoryUsage() const { return memoryUsage; }
+
+// Rebuilds 'generation' into 'grid' (same size and world position as when recorded),
+// starting from the nearest keyframe and applying the deltas after it
+// Returns false if the generation is not in the history
+bool History::restore(int generation, Grid& grid) const {
+    if (!contains(generation)) return false;
+
+    std::size_t target = static_cast<std::size_t>(generation - firstGeneration);
+    std::size_t index = target;
+    while (!frames[index].keyframe) index--;
+
+    const Frame* frame = &frames[index];
+    std::vector<Bitmap> planes(frame->planes.size(), Bitmap(frame->width, frame->height));
+    for (std::size_t p = 0; p < planes.size(); p++) decodeKeyframe(frame->planes[p], planes[p]);
+    int originX = frame->originX, originY = frame->originY;
+    int width = frame->width, height = frame->height;
+
+    for (index++; index <= target; index++) {
+        frame = &frames[index];
+        while (planes.size() < frame->planes.size()) planes.emplace_back(width, height);
+        if (frame->originX == originX && frame->originY == originY && frame->width == width && frame->height == height) {
+            // same area: the delta applies in place, in time proportional to its size
+            for (std::size_t p = 0; p < frame->planes.size(); p++) decodeBitsXor(frame->planes[p], 0, planes[p]);
+            continue;
+        }
+
+        // the grid was resized: apply the delta over the union of both areas
+        int x0 = std::min(originX, frame->originX);
+        int y0 = std::min(originY, frame->originY);
+        int x1 = std::max(originX + width, frame->originX + frame->width);
+        int y1 = std::max(originY + height, frame->originY + frame->height);
+        for (std::size_t p = 0; p < planes.size(); p++) {
+            Bitmap merged = place(planes[p], originX - x0, originY - y0, x1 - x0, y1 - y0);
+            if (p < frame->planes.size()) decodeBitsXor(frame->planes[p], 0, merged);
+            planes[p] = place(merged, x0 - frame->originX, y0 - frame->originY, frame->width, frame->height);
+        }
+        originX = frame->originX;
+        originY = frame->originY;
+        width = frame->width;
+        height = frame->height;
+    }
+
+    // dying states are written cell by cell, the live cells (state 1) as a patch, which
+    // also recomputes the statistics
+    grid = Grid(width, height);
+    grid.setOrigin(originX, originY);
+    Bitmap alive = planes[0];
+    for (std::size_t p = 1; p < planes.size(); p++) {
+        for (int y = 0; y < height; y++) {
+            const std::uint64_t* row = planes[p].row(y);
+            std::uint64_t* aliveRow = alive.row(y);
+            for (int word = 0; word < planes[p].getWordsPerRow(); word++) {
+                aliveRow[word] &= ~row[word];
+                std::uint64_t bitsLeft = row[word];
+                while (bitsLeft != 0) {
+                    int x = word * 64 + __builtin_ctzll(bitsLeft);
+                    bitsLeft &= bitsLeft - 1;
+                    Cell& cell = grid.at(x, y);
+                    int state = cell.getState() | (1 << p);
+                    if ((planes[0].row(y)[word] >> (x % 64)) & 1) state |= 1;
+                    cell.setState(state);
+                }
+            }
+        }
+    }
+    grid.applyPatch(alive, originX, originY, Grid::PatchMode::Or);
+    return true;
+}
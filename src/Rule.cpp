@@ -0,0 +1,175 @@
+#include "Rule.h"
+#include <cctype>
+#include <sstream>
+#include <vector>
+
+// Default constructor initializes Conway's rule B3/S23
+Rule::Rule() : birthMask(1u << 3), survivalMask((1u << 2) | (1u << 3)), states(2),
+               largerThanLife(false), range(1), neighborhood(Neighborhood::Moore), countCenter(false),
+               birthMin(3), birthMax(3), survivalMin(2), survivalMax(3) {}
+
+// Converts a string of digits 0-8 to a neighbour count bitmask
+// Returns false if the string contains anything else
+static bool digitsToMask(const std::string& digits, std::uint32_t& mask) {
+    mask = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '8') return false;
+        mask |= 1u << (c - '0');
+    }
+    return true;
+}
+
+// Parses a non-negative integer that makes up the whole string
+// Returns false if the string is empty, not a number or too large
+static bool parseCount(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 6) return false;
+    for (char c : text) if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    value = std::stoi(text);
+    return true;
+}
+
+// Parses a rule specification (see Rule.h for the accepted notations)
+// Returns true if successful; on failure the rule is left unchanged
+bool Rule::parse(const std::string& spec) {
+    if (spec.find(',') != std::string::npos) return parseLargerThanLife(spec);
+
+    std::vector<std::string> parts;
+    std::stringstream stream(spec);
+    std::string part;
+    while (std::getline(stream, part, '/')) parts.push_back(part);
+    if (!spec.empty() && spec.back() == '/') parts.push_back("");
+    if (parts.size() < 2 || parts.size() > 3) return false;
+
+    std::uint32_t birth = 0, survival = 0;
+    int numStates = 2;
+    bool letters = false;
+    for (const std::string& p : parts) {
+        if (!p.empty() && std::isalpha(static_cast<unsigned char>(p[0]))) letters = true;
+    }
+
+    if (letters) {
+        // B.../S.../C... in any order
+        bool hasB = false, hasS = false;
+        for (const std::string& p : parts) {
+            if (p.empty()) return false;
+            char key = static_cast<char>(std::toupper(static_cast<unsigned char>(p[0])));
+            std::string value = p.substr(1);
+            if (key == 'B' && !hasB) {
+                if (!digitsToMask(value, birth)) return false;
+                hasB = true;
+            } else if (key == 'S' && !hasS) {
+                if (!digitsToMask(value, survival)) return false;
+                hasS = true;
+            } else if (key == 'C' || key == 'G') {
+                if (!parseCount(value, numStates)) return false;
+            } else {
+                return false;
+            }
+        }
+        if (!hasB || !hasS) return false;
+    } else {
+        // S/B or S/B/C
+        if (!digitsToMask(parts[0], survival) || !digitsToMask(parts[1], birth)) return false;
+        if (parts.size() == 3 && !parseCount(parts[2], numStates)) return false;
+    }
+
+    if (numStates < 2 || numStates > 255) return false;
+    *this = Rule();
+    birthMask = birth;
+    survivalMask = survival;
+    states = numStates;
+    return true;
+}
+
+// Parses a "min..max" count range
+static bool parseCountRange(const std::string& text, int& min, int& max) {
+    std::size_t dots = text.find("..");
+    if (dots == std::string::npos) return false;
+    return parseCount(text.substr(0, dots), min) && parseCount(text.substr(dots + 2), max) && min <= max;
+}
+
+// Parses a Larger than Life rule "R<r>,C<c>,M<0|1>,S<min>..<max>,B<min>..<max>,N<M|N>"
+// R, S and B are required; C defaults to 0 (two states), M to 0 and N to M (Moore)
+// R is limited to 1..500 like in Golly (the kernel grows the grid by R on every side)
+// Returns true if successful; on failure the rule is left unchanged
+bool Rule::parseLargerThanLife(const std::string& spec) {
+    Rule parsed;
+    parsed.largerThanLife = true;
+    parsed.countCenter = false;
+    bool hasR = false, hasS = false, hasB = false;
+
+    std::stringstream stream(spec);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (part.size() < 2) return false;
+        char key = static_cast<char>(std::toupper(static_cast<unsigned char>(part[0])));
+        std::string value = part.substr(1);
+        int number = 0;
+        if (key == 'R' && parseCount(value, number) && number >= 1 && number <= 500) {
+            parsed.range = number;
+            hasR = true;
+        } else if (key == 'C' && parseCount(value, number) && number != 1 && number <= 255) {
+            parsed.states = number < 2 ? 2 : number;
+        } else if (key == 'M' && (value == "0" || value == "1")) {
+            parsed.countCenter = value == "1";
+        } else if (key == 'S' && parseCountRange(value, parsed.survivalMin, parsed.survivalMax)) {
+            hasS = true;
+        } else if (key == 'B' && parseCountRange(value, parsed.birthMin, parsed.birthMax)) {
+            hasB = true;
+        } else if (key == 'N' && (value == "M" || value == "N")) {
+            parsed.neighborhood = value == "M" ? Neighborhood::Moore : Neighborhood::VonNeumann;
+        } else {
+            return false;
+        }
+    }
+    if (!hasR || !hasS || !hasB) return false;
+
+    *this = parsed;
+    return true;
+}
+
+// Returns the rule in B/S notation, with a /C suffix for Generations rules,
+// or in R,C,M,S,B,N notation for Larger than Life rules
+std::string Rule::toString() const {
+    if (largerThanLife) {
+        return "R" + std::to_string(range) + ",C" + std::to_string(states > 2 ? states : 0)
+             + ",M" + (countCenter ? "1" : "0")
+             + ",S" + std::to_string(survivalMin) + ".." + std::to_string(survivalMax)
+             + ",B" + std::to_string(birthMin) + ".." + std::to_string(birthMax)
+             + ",N" + (neighborhood == Neighborhood::Moore ? "M" : "N");
+    }
+    std::string result = "B";
+    for (int n = 0; n <= 8; n++) if (birthMask & (1u << n)) result += char('0' + n);
+    result += "/S";
+    for (int n = 0; n <= 8; n++) if (survivalMask & (1u << n)) result += char('0' + n);
+    if (states > 2) result += "/C" + std::to_string(states);
+    return result;
+}
+
+// Returns true if a dead cell with 'neighbors' live neighbours is born
+bool Rule::isBirth(int neighbors) const {
+    if (largerThanLife) return neighbors >= birthMin && neighbors <= birthMax;
+    return (birthMask >> neighbors) & 1u;
+}
+
+// Returns true if a live cell with 'neighbors' live neighbours stays alive
+bool Rule::isSurvival(int neighbors) const {
+    if (largerThanLife) return neighbors >= survivalMin && neighbors <= survivalMax;
+    return (survivalMask >> neighbors) & 1u;
+}
+
+// Returns the number of cell states (2 for Life-like rules)
+int Rule::getStates() const { return states; }
+
+
+// Returns true if the rule uses the Larger than Life notation (range and count ranges)
+bool Rule::isLargerThanLife() const { return largerThanLife; }
+
+// Returns the neighbourhood range (1 for Life-like and Generations rules)
+int Rule::getRange() const { return range; }
+
+// Returns the neighbourhood shape
+Rule::Neighborhood Rule::getNeighborhood() const { return neighborhood; }
+
+// Returns true if the cell itself is part of its neighbour count
+bool Rule::includesCenter() const { return countCenter; }
@@ -0,0 +1,261 @@
+#include "StreamStepper.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <system_error>
+#include <vector>
+#include "Kernels.h"
+
+// Constructor: Conway's rules, 256-row strips, 8 generations per pass
+StreamStepper::StreamStepper() : stripHeight(256), generationsPerPass(8) {
+    setRule(Rule());
+}
+
+// Sets the rule; only two-state rules with the Moore neighbourhood of range 1 can be streamed
+// Returns false (and keeps the previous rule) otherwise
+bool StreamStepper::setRule(const Rule& rule) {
+    if (rule.getStates() != 2 || rule.isLargerThanLife()) return false;
+    for (int n = 0; n <= 8; n++) {
+        birth[n] = rule.isBirth(n);
+        survival[n] = rule.isSurvival(n);
+    }
+    return true;
+}
+
+// Sets the number of rows per strip (raised to the generations per pass when smaller)
+void StreamStepper::setStripHeight(int rows) { stripHeight = std::max(rows, 1); }
+
+// Sets how many generations each pass over the file advances
+void StreamStepper::setGenerationsPerPass(int generations) { generationsPerPass = std::max(generations, 1); }
+
+// Reads a P4 header up to the single whitespace before the raster
+static bool readHeader(std::istream& file, int& width, int& height) {
+    std::string magic;
+    file >> magic;
+    if (magic != "P4") return false;
+    auto skipComments = [&file]() {
+        while (file >> std::ws && file.peek() == '#') {
+            std::string line;
+            std::getline(file, line);
+        }
+    };
+    skipComments();
+    file >> width;
+    skipComments();
+    file >> height;
+    file.get();
+    return file && width > 0 && height > 0;
+}
+
+// Reads 'rows' rows of MSB-first bytes into a bitmap (an empty bitmap on a read error)
+static Bitmap readStrip(std::istream& file, int width, int rows) {
+    Bitmap strip(width, rows);
+    std::vector<unsigned char> bytes((width + 7) / 8);
+    for (int y = 0; y < rows; y++) {
+        if (!file.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) return Bitmap();
+        std::uint64_t* row = strip.row(y);
+        for (int x = 0; x < width; x++) {
+            if ((bytes[x / 8] >> (7 - x % 8)) & 1) row[x / 64] |= std::uint64_t(1) << (x % 64);
+        }
+    }
+    return strip;
+}
+
+// Writes the rows of a bitmap as MSB-first bytes
+static bool writeStrip(std::ostream& file, const Bitmap& strip) {
+    std::vector<unsigned char> bytes((strip.getWidth() + 7) / 8);
+    for (int y = 0; y < strip.getHeight(); y++) {
+        std::fill(bytes.begin(), bytes.end(), 0);
+        const std::uint64_t* row = strip.row(y);
+        for (int x = 0; x < strip.getWidth(); x++) {
+            if ((row[x / 64] >> (x % 64)) & 1) bytes[x / 8] |= 0x80 >> (x % 8);
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    return static_cast<bool>(file);
+}
+
+// Returns true if both paths name the same file (existing or not)
+static bool samePath(const std::string& a, const std::string& b) {
+    std::error_code error;
+    if (std::filesystem::exists(a, error) && std::filesystem::exists(b, error)) {
+        return std::filesystem::equivalent(a, b, error);
+    }
+    return std::filesystem::weakly_canonical(a, error) == std::filesystem::weakly_canonical(b, error);
+}
+
+// Advances the board in 'inputPath' by 'generations' and writes it to 'outputPath'
+// Every pass writes to a temporary file next to the output; the last one replaces the
+// output only when all passes succeeded, so a failed run leaves an existing output intact
+// Returns false on an I/O or format error, or if the input is the output or one of
+// its temporary files (the input would be overwritten)
+bool StreamStepper::run(const std::string& inputPath, const std::string& outputPath, int generations) {
+    const std::string temporary[2] = {outputPath + ".pass0", outputPath + ".pass1"};
+    if (samePath(inputPath, outputPath) || samePath(inputPath, temporary[0]) || samePath(inputPath, temporary[1])) {
+        return false;
+    }
+
+    std::string source = inputPath;
+    int remaining = std::max(generations, 0);
+    int pass = 0;
+    bool ok = true;
+    do {
+        int step = std::min(remaining, generationsPerPass);
+        remaining -= step;
+        ok = runPass(source, temporary[pass % 2], step);
+        source = temporary[pass % 2];
+        pass++;
+    } while (ok && remaining > 0);
+
+    if (ok) ok = std::rename(source.c_str(), outputPath.c_str()) == 0;
+    std::remove(temporary[0].c_str());
+    std::remove(temporary[1].c_str());
+    return ok;
+}
+
+// One pass over the file: every strip is advanced by 'generations' with its halos
+bool StreamStepper::runPass(const std::string& inputPath, const std::string& outputPath, int generations) const {
+    std::ifstream input(inputPath, std::ios::binary);
+    if (!input.is_open()) return false;
+    int width, height;
+    if (!readHeader(input, width, height)) return false;
+
+    std::ofstream output(outputPath, std::ios::binary);
+    if (!output.is_open()) return false;
+    output << "P4\n" << width << " " << height << "\n";
+
+    const int rows = std::max(stripHeight, generations);
+    const int strips = (height + rows - 1) / rows;
+    auto readAsync = [&](int strip) {
+        int count = std::min(rows, height - strip * rows);
+        return std::async(std::launch::async, [&input, width, count]() { return readStrip(input, width, count); });
+    };
+
+    // sliding window: the halo rows of the previous strip, the current and the next strip
+    // resident, the strip after them being read
+    Bitmap previous;
+    std::future<Bitmap> reading = readAsync(0);
+    Bitmap current = reading.get();
+    if (current.getHeight() == 0) return false;
+    if (strips > 1) reading = readAsync(1);
+
+    std::future<bool> writing;
+    bool ok = true;
+    for (int strip = 0; strip < strips && ok; strip++) {
+        Bitmap next;
+        if (strip + 1 < strips) {
+            next = reading.get();
+            if (next.getHeight() == 0) ok = false;
+            else if (strip + 2 < strips) reading = readAsync(strip + 2);
+        }
+        if (!ok) break;
+
+        Bitmap result = stepWindow(previous, current, next, generations);
+        if (writing.valid() && !writing.get()) ok = false;
+        writing = std::async(std::launch::async, [&output](Bitmap rows) { return writeStrip(output, rows); },
+                             std::move(result));
+
+        // only the bottom halo rows of the current strip are needed for the next one
+        int halo = std::min(generations, current.getHeight());
+        previous = Bitmap(width, halo);
+        for (int y = 0; y < halo; y++) {
+            std::copy(current.row(current.getHeight() - halo + y),
+                      current.row(current.getHeight() - halo + y) + current.getWordsPerRow(), previous.row(y));
+        }
+        current = std::move(next);
+    }
+    if (reading.valid()) reading.wait();
+    if (writing.valid() && !writing.get()) ok = false;
+    return ok;
+}
+
+// Steps the current strip together with up to 'generations' halo rows taken from the
+// neighbouring strips, and returns the rows of the current strip
+// Rows beyond the window are taken as dead: the resulting error moves one row per
+// generation, so it never reaches the current strip
+Bitmap StreamStepper::stepWindow(const Bitmap& previous, const Bitmap& current, const Bitmap& next,
+                                 int generations) const {
+    const int width = current.getWidth();
+    const int words = current.getWordsPerRow();
+    const int top = std::min(generations, previous.getHeight());
+    const int bottom = std::min(generations, next.getHeight());
+
+    Bitmap window(width, top + current.getHeight() + bottom);
+    for (int y = 0; y < top; y++) {
+        std::copy(previous.row(previous.getHeight() - top + y), previous.row(previous.getHeight() - top + y) + words,
+                  window.row(y));
+    }
+    for (int y = 0; y < current.getHeight(); y++) {
+        std::copy(current.row(y), current.row(y) + words, window.row(top + y));
+    }
+    for (int y = 0; y < bottom; y++) {
+        std::copy(next.row(y), next.row(y) + words, window.row(top + current.getHeight() + y));
+    }
+
+    Bitmap scratch(width, window.getHeight());
+    for (int g = 0; g < generations; g++) {
+        stepBitmap(window, scratch);
+        std::swap(window, scratch);
+    }
+
+    Bitmap result(width, current.getHeight());
+    for (int y = 0; y < current.getHeight(); y++) {
+        std::copy(window.row(top + y), window.row(top + y) + words, result.row(y));
+    }
+    return result;
+}
+
+// Advances a packed bitmap by one generation, 64 cells at a time
+// The eight neighbours are summed in bit-sliced counters (one bit plane per counter bit)
+// and the rule is applied to each possible count
+GOL_KERNEL
+void StreamStepper::stepBitmap(const Bitmap& source, Bitmap& target) const {
+    const int words = source.getWordsPerRow();
+    const int height = source.getHeight();
+    const std::uint64_t lastMask = source.getWidth() % 64 == 0
+                                       ? ~std::uint64_t(0)
+                                       : (std::uint64_t(1) << (source.getWidth() % 64)) - 1;
+    const std::vector<std::uint64_t> empty(words, 0);
+
+    for (int y = 0; y < height; y++) {
+        const std::uint64_t* above = y > 0 ? source.row(y - 1) : empty.data();
+        const std::uint64_t* middle = source.row(y);
+        const std::uint64_t* below = y + 1 < height ? source.row(y + 1) : empty.data();
+        std::uint64_t* out = target.row(y);
+
+        for (int i = 0; i < words; i++) {
+            std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            auto add = [&](std::uint64_t v) {
+                std::uint64_t c0 = s0 & v;
+                s0 ^= v;
+                std::uint64_t c1 = s1 & c0;
+                s1 ^= c0;
+                std::uint64_t c2 = s2 & c1;
+                s2 ^= c1;
+                s3 |= c2;
+            };
+            auto addRow = [&](const std::uint64_t* row, bool center) {
+                std::uint64_t word = row[i];
+                add((word << 1) | (i > 0 ? row[i - 1] >> 63 : 0));
+                add((word >> 1) | (i + 1 < words ? row[i + 1] << 63 : 0));
+                if (center) add(word);
+            };
+            addRow(above, true);
+            addRow(middle, false);
+            addRow(below, true);
+
+            std::uint64_t alive = middle[i];
+            std::uint64_t result = 0;
+            for (int n = 0; n <= 8; n++) {
+                if (!birth[n] && !survival[n]) continue;
+                std::uint64_t count = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) &
+                                      ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+                result |= count & ((birth[n] ? ~alive : 0) | (survival[n] ? alive : 0));
+            }
+            out[i] = i + 1 == words ? result & lastMask : result;
+        }
+    }
+}
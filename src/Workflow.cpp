@@ -1,6 +1,8 @@
 #include "Workflow.h"
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <ctime>
 
 // Constructor for Workflow class
 Workflow::Workflow() {}
@@ -15,6 +17,8 @@ void Workflow::runMainLoop() {
         if(askLoadFromFile()) initFromFile();
         else initRandom();
 
+        askRule();
+
         int steps, delayMs;
         askStepsAndDelay(steps, delayMs);
         game.setSteps(steps);
@@ -66,13 +70,20 @@ bool Workflow::askLoadFromFile() {
 }
 
 
+// Returns true if the filename already ends in .pbm or .pgm
+static bool hasImageExtension(const std::string& filename) {
+    if (filename.size() < 4) return false;
+    std::string ext = filename.substr(filename.size() - 4);
+    return ext == ".pbm" || ext == ".pgm";
+}
+
 // Asks the user for the file path to load the grid from.
 // @return the full path to the input file as a string.
 std::string Workflow::askFilePath() {
     std::string filename;
-    std::cout << "Enter filename (in input/): ";
+    std::cout << "Enter filename (in input/, .pbm or .pgm): ";
     std::cin >> filename;
-    if(filename.size() < 4 || filename.substr(filename.size() - 4) != ".pbm") filename += ".pbm";
+    if(!hasImageExtension(filename)) filename += ".pbm";
     return "../input/" + filename;
 }
 
@@ -89,18 +100,21 @@ int checkPositive(int val) {
 // parameters:
 // - w Reference to grid width.
 // - h Reference to grid height.
-// - p Reference to live cell probability (0-100).
+// - p Reference to live cell probability in percent (0-100, fractions allowed).
 
-void Workflow::askRandomGridParams(int& w, int& h, int& p) {
+void Workflow::askRandomGridParams(int& w, int& h, double& p) {
     std::cout << "Enter grid size X (ex. 80): ";
     std::cin >> w;
     w = checkPositive(w);
     std::cout << "Enter grid size Y (ex. 20): ";
     std::cin >> h;
     h = checkPositive(h);
-    std::cout << "Enter live cell probability (0-100): ";
+    std::cout << "Enter live cell probability (0-100, ex. 12.5): ";
     std::cin >> p;
-    p = checkPositive(p);
+    while (p < 0 || p > 100) {
+        std::cout << "Please enter a probability between 0 and 100: ";
+        std::cin >> p;
+    }
 }
 
 
@@ -118,6 +132,20 @@ void Workflow::askStepsAndDelay(int& steps, int& delayMs) {
 }
 
 
+// Asks the user for the rule to simulate (Life-like or Generations notation).
+void Workflow::askRule() {
+    std::string spec;
+    Rule rule;
+    std::cout << "Enter rule (ex. B3/S23, B2/S/C3 or R5,C0,M1,S34..58,B34..45,NM): ";
+    std::cin >> spec;
+    while (!rule.parse(spec)) {
+        std::cout << "Invalid rule! Enter rule (ex. B3/S23): ";
+        std::cin >> spec;
+    }
+    game.setRule(rule);
+}
+
+
 // Asks the user whether to save the final grid constellation.
 // Return true if user wants to save, false otherwise.
 bool Workflow::askSaveFinal() {
@@ -133,9 +161,9 @@ bool Workflow::askSaveFinal() {
 // Return the full path to the output file as a string.
 std::string Workflow::askOutputFilePath() {
     std::string filename;
-    std::cout << "Enter filename (in output/): ";
+    std::cout << "Enter filename (in output/, .pgm keeps dying states): ";
     std::cin >> filename;
-    if(filename.size() < 4 || filename.substr(filename.size() - 4) != ".pbm") filename += ".pbm";
+    if(!hasImageExtension(filename)) filename += ".pbm";
     return "../output/" + filename;
 }
 
@@ -147,9 +175,10 @@ void Workflow::initFromFile() {
     Grid g;
     if (!g.loadFromFile(path)) {
         std::cout << "Error loading file. Falling back to random grid.\n";
-        int w = 80, h = 20, p = 20;
+        int w = 80, h = 20;
+        double p = 20;
         askRandomGridParams(w, h, p);
-        g.randomInit(w, h, p);
+        g.randomInit(w, h, p / 100.0, static_cast<std::uint64_t>(time(NULL)));
     }
     game.setGrid(g);
 }
@@ -157,10 +186,11 @@ void Workflow::initFromFile() {
 
 // Initializes the grid randomly based on user-specified parameters.
 void Workflow::initRandom() {
-    int w, h, p;
+    int w, h;
+    double p;
     askRandomGridParams(w, h, p);
     Grid g;
-    g.randomInit(w, h, p);
+    g.randomInit(w, h, p / 100.0, static_cast<std::uint64_t>(time(NULL)));
     game.setGrid(g);
 }
 
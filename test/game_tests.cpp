@@ -1,9 +1,18 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include "Bitmap.h"
 #include "Grid.h"
 #include "Game.h"
 #include "Cell.h"
+#include "Census.h"
+#include "Rule.h"
+#include "StreamStepper.h"
 
 // =========================================================
 // Test Grid: verify randomInit creates grid with correct dimensions
@@ -15,6 +24,47 @@ TEST(GridTest, RandomInitSize) {
     EXPECT_EQ(grid.getHeight(), 20);
 }
 
+// =========================================================
+// Test Grid: verify seeded randomInit is reproducible and thread-independent
+// =========================================================
+TEST(GridTest, RandomInitSeededReproducible) {
+    Grid single, multi, other;
+    single.randomInit(150, 130, 0.3, 42, 1);
+    multi.randomInit(150, 130, 0.3, 42, 4);
+    other.randomInit(150, 130, 0.3, 43, 4);
+
+    bool differs = false;
+    for (int y = 0; y < single.getHeight(); ++y) {
+        for (int x = 0; x < single.getWidth(); ++x) {
+            ASSERT_EQ(single.at(x, y).isAliveNow(), multi.at(x, y).isAliveNow())
+                << "Mismatch at (" << x << "," << y << ")";
+            if (single.at(x, y).isAliveNow() != other.at(x, y).isAliveNow()) differs = true;
+        }
+    }
+    EXPECT_TRUE(differs);
+    EXPECT_EQ(single.getPopulation(), multi.getPopulation());
+}
+
+// =========================================================
+// Test Grid: verify randomInit honours fractional densities
+// =========================================================
+TEST(GridTest, RandomInitFractionalDensity) {
+    Grid grid;
+    const int cells = 400 * 400;
+    grid.randomInit(400, 400, 0.125, 7);
+    EXPECT_NEAR(grid.getPopulation() / double(cells), 0.125, 0.01);
+
+    grid.randomInit(400, 400, 0.003, 7);
+    EXPECT_NEAR(grid.getPopulation() / double(cells), 0.003, 0.001);
+
+    grid.randomInit(10, 10, 1.0, 7);
+    EXPECT_EQ(grid.getPopulation(), 100);
+    grid.randomInit(10, 10, 0.0, 7);
+    EXPECT_EQ(grid.getPopulation(), 0);
+    grid.randomInit(10, 10, std::nan(""), 7);
+    EXPECT_EQ(grid.getPopulation(), 0);
+}
+
 // =========================================================
 // Test Grid: verify loadFromFile creates grid with correct dimensions
 // =========================================================
@@ -115,7 +165,7 @@ TEST(GridTest, StepClassicRulesBlinker) {
 // =========================================================
 TEST(GridTest, InfinityGridResizing) {
     Grid grid;
-    grid.randomInit(3, 3);
+    grid.randomInit(3, 3, 0.0, 1);  // all cells dead, the pattern is set below
     
     // Set up a pattern that will grow beyond current boundaries
     grid.at(0, 0).setAlive(true);
@@ -139,6 +189,550 @@ TEST(GridTest, InfinityGridResizing) {
 }
 
 
+// =========================================================
+// Test Grid: verify incremental statistics match a full scan
+// =========================================================
+TEST(GridTest, StatisticsMatchFullScan) {
+    Grid grid;
+    grid.loadFromFile("../input/glider_test.pbm");
+    EXPECT_EQ(grid.getPopulation(), 5);
+    EXPECT_EQ(grid.getBirths(), 0);
+    EXPECT_EQ(grid.getDeaths(), 0);
+
+    for (int step = 0; step < 8; ++step) {
+        grid.stepClassicRules(true);
+
+        int alive = 0;
+        int minX = grid.getWidth(), minY = grid.getHeight(), maxX = -1, maxY = -1;
+        for (int y = 0; y < grid.getHeight(); ++y) {
+            for (int x = 0; x < grid.getWidth(); ++x) {
+                if (!grid.at(x, y).isAliveNow()) continue;
+                alive++;
+                minX = std::min(minX, x); maxX = std::max(maxX, x);
+                minY = std::min(minY, y); maxY = std::max(maxY, y);
+            }
+        }
+        EXPECT_EQ(grid.getPopulation(), alive);
+        EXPECT_EQ(grid.getPopulation(), 5);          // glider keeps its size
+        EXPECT_EQ(grid.getBirths(), grid.getDeaths());
+        EXPECT_GT(grid.getBirths(), 0);
+
+        int bMinX, bMinY, bMaxX, bMaxY;
+        ASSERT_TRUE(grid.getBoundingBox(bMinX, bMinY, bMaxX, bMaxY));
+        EXPECT_EQ(bMinX, minX + grid.getOriginX());   // bounding box is in world coordinates
+        EXPECT_EQ(bMinY, minY + grid.getOriginY());
+        EXPECT_EQ(bMaxX, maxX + grid.getOriginX());
+        EXPECT_EQ(bMaxY, maxY + grid.getOriginY());
+    }
+}
+
+// =========================================================
+// Test Grid: verify statistics of an empty grid
+// =========================================================
+TEST(GridTest, StatisticsEmptyGrid) {
+    Grid grid(4, 4);
+    int minX, minY, maxX, maxY;
+    EXPECT_EQ(grid.getPopulation(), 0);
+    EXPECT_FALSE(grid.getBoundingBox(minX, minY, maxX, maxY));
+}
+
+
+// =========================================================
+// Test Grid: verify extractRegion matches per-cell access
+// =========================================================
+TEST(GridTest, ExtractRegionMatchesCells) {
+    Grid grid;
+    grid.loadFromFile("../input/wikipedia_test.pbm");
+
+    // region partly outside of the grid: outside cells read as dead
+    Bitmap region = grid.extractRegion(-3, -2, 90, 25);
+    EXPECT_EQ(region.count(), grid.getPopulation());
+    for (int y = 0; y < region.getHeight(); ++y) {
+        for (int x = 0; x < region.getWidth(); ++x) {
+            bool expected = grid.isInside(x - 3, y - 2) && grid.at(x - 3, y - 2).isAliveNow();
+            ASSERT_EQ(region.get(x, y), expected) << "Mismatch at (" << x << "," << y << ")";
+        }
+    }
+    EXPECT_EQ(grid.countAliveInRegion(10, 0, 20, 5), grid.extractRegion(10, 0, 20, 5).count());
+
+    int visited = 0;
+    grid.forEachAliveInRegion(10, 0, 20, 5, [&](int x, int y) {
+        EXPECT_TRUE(grid.at(x, y).isAliveNow());
+        visited++;
+    });
+    EXPECT_EQ(visited, grid.countAliveInRegion(10, 0, 20, 5));
+}
+
+// =========================================================
+// Test Grid: verify applyPatch modes and growth keep world coordinates
+// =========================================================
+TEST(GridTest, ApplyPatchGrowsAndKeepsCoordinates) {
+    Grid grid;
+    grid.loadFromFile("../input/glider_test.pbm");
+    Bitmap glider = grid.extractRegion(0, 0, 5, 5);
+
+    Bitmap block(2, 2);
+    block.set(0, 0, true); block.set(1, 0, true);
+    block.set(0, 1, true); block.set(1, 1, true);
+
+    grid.applyPatch(block, -10, -10, Grid::PatchMode::Or);
+    EXPECT_GE(grid.getWidth(), 15);
+    EXPECT_GE(grid.getHeight(), 15);
+    EXPECT_EQ(grid.countAliveInRegion(-10, -10, 2, 2), 4);
+    EXPECT_EQ(grid.getPopulation(), 9);
+    EXPECT_EQ(grid.extractRegion(0, 0, 5, 5), glider);
+
+    grid.applyPatch(block, -10, -10, Grid::PatchMode::Xor);
+    EXPECT_EQ(grid.countAliveInRegion(-10, -10, 2, 2), 0);
+    EXPECT_EQ(grid.getPopulation(), 5);
+
+    grid.applyPatch(Bitmap(5, 5), 0, 0, Grid::PatchMode::Copy);
+    EXPECT_EQ(grid.getPopulation(), 0);
+    grid.applyPatch(glider, 0, 0);
+    EXPECT_EQ(grid.extractRegion(0, 0, 5, 5), glider);
+}
+
+// =========================================================
+// Test Grid: verify region counts and patches see cells edited through at()
+// =========================================================
+TEST(GridTest, RegionStatsSeeDirectCellEdits) {
+    Grid grid(4, 4);
+    grid.at(1, 1).setAlive(true);
+    EXPECT_EQ(grid.countAliveInRegion(0, 0, 4, 4), 1);
+    EXPECT_EQ(grid.countAliveInRegion(0, 0, 3, 3), 1);
+
+    Bitmap dot(1, 1);
+    dot.set(0, 0, true);
+    grid.applyPatch(dot, 3, 3, Grid::PatchMode::Or);
+    EXPECT_EQ(grid.getPopulation(), 2);
+    int minX, minY, maxX, maxY;
+    ASSERT_TRUE(grid.getBoundingBox(minX, minY, maxX, maxY));
+    EXPECT_EQ(minX, 1);
+    EXPECT_EQ(minY, 1);
+    EXPECT_EQ(maxX, 3);
+    EXPECT_EQ(maxY, 3);
+
+    // clearing the cell on the box edge shrinks the box again
+    grid.applyPatch(dot, 3, 3, Grid::PatchMode::Xor);
+    EXPECT_EQ(grid.getPopulation(), 1);
+    ASSERT_TRUE(grid.getBoundingBox(minX, minY, maxX, maxY));
+    EXPECT_EQ(maxX, 1);
+    EXPECT_EQ(maxY, 1);
+}
+
+// =========================================================
+// Test Grid: verify region coordinates survive infinity grid resizing
+// =========================================================
+TEST(GridTest, RegionCoordinatesStableAcrossResize) {
+    Grid grid;
+    grid.loadFromFile("../input/glider_test.pbm");
+    Bitmap start = grid.extractRegion(0, 0, 5, 5);
+
+    // a glider repeats its shape after 4 generations, moved by one cell diagonally
+    for (int step = 0; step < 4; ++step) grid.stepClassicRules(true);
+
+    int found = 0;
+    for (int dy = -1; dy <= 1; dy += 2) {
+        for (int dx = -1; dx <= 1; dx += 2) {
+            if (grid.extractRegion(dx, dy, 5, 5) == start) found++;
+        }
+    }
+    EXPECT_EQ(found, 1);
+    EXPECT_EQ(grid.countAliveInRegion(-100, -100, 200, 200), 5);
+}
+
+
+// =========================================================
+// Test Grid: verify front expansion moves the origin, not the cells
+// =========================================================
+TEST(GridTest, WorldCoordinatesStableAcrossFrontExpansion) {
+    Grid grid;
+    grid.randomInit(3, 3, 0.0, 1);
+
+    // vertical blinker touching the top and left edges
+    grid.at(0, 0).setAlive(true);
+    grid.at(0, 1).setAlive(true);
+    grid.at(0, 2).setAlive(true);
+
+    grid.stepClassicRules(true);
+    EXPECT_EQ(grid.getOriginX(), -1);
+    EXPECT_EQ(grid.getOriginY(), -1);
+
+    // horizontal phase around the old middle cell, still at the same world coordinates
+    // (the new column is only evaluated from the next step on)
+    EXPECT_FALSE(grid.atWorld(-1, 1).isAliveNow());
+    EXPECT_TRUE(grid.atWorld(0, 1).isAliveNow());
+    EXPECT_TRUE(grid.atWorld(1, 1).isAliveNow());
+    EXPECT_FALSE(grid.atWorld(0, 0).isAliveNow());
+    EXPECT_FALSE(grid.isInsideWorld(-2, 0));
+
+    int minX, minY, maxX, maxY;
+    ASSERT_TRUE(grid.getBoundingBox(minX, minY, maxX, maxY));
+    EXPECT_EQ(minX, 0);
+    EXPECT_EQ(minY, 1);
+    EXPECT_EQ(maxX, 1);
+    EXPECT_EQ(maxY, 1);
+}
+
+// =========================================================
+// Test Grid: verify the origin is persisted in saved files
+// =========================================================
+TEST(GridTest, SaveLoadKeepsOrigin) {
+    const std::string path = "../output/origin_test.pbm";
+    Grid grid;
+    grid.loadFromFile("../input/glider_test.pbm");
+    for (int step = 0; step < 12; ++step) grid.stepClassicRules(true);
+    ASSERT_TRUE(grid.saveToFile(path));
+
+    Grid loaded;
+    ASSERT_TRUE(loaded.loadFromFile(path));
+    EXPECT_EQ(loaded.getOriginX(), grid.getOriginX());
+    EXPECT_EQ(loaded.getOriginY(), grid.getOriginY());
+    EXPECT_EQ(loaded.getWidth(), grid.getWidth());
+    EXPECT_EQ(loaded.getHeight(), grid.getHeight());
+    EXPECT_EQ(loaded.extractRegion(-50, -50, 100, 100), grid.extractRegion(-50, -50, 100, 100));
+    std::remove(path.c_str());
+}
+
+
+// =========================================================
+// Test Rule: verify parsing of Life-like and Generations notations
+// =========================================================
+TEST(RuleTest, ParseNotations) {
+    Rule rule;
+    EXPECT_EQ(rule.toString(), "B3/S23");
+
+    ASSERT_TRUE(rule.parse("B36/S23"));
+    EXPECT_TRUE(rule.isBirth(6));
+    EXPECT_FALSE(rule.isSurvival(6));
+    EXPECT_EQ(rule.getStates(), 2);
+
+    ASSERT_TRUE(rule.parse("B2/S/C3"));          // Brian's Brain
+    EXPECT_EQ(rule.toString(), "B2/S/C3");
+
+    ASSERT_TRUE(rule.parse("345/2/4"));          // Star Wars in S/B/C notation
+    EXPECT_EQ(rule.toString(), "B2/S345/C4");
+
+    EXPECT_FALSE(rule.parse("B9/S23"));
+    EXPECT_FALSE(rule.parse("B3"));
+    EXPECT_FALSE(rule.parse("B3/S23/C1"));
+    EXPECT_FALSE(rule.parse("B3/S23/C99999999999"));   // out of range, no exception
+    EXPECT_FALSE(rule.parse("23/3/99999999999"));
+    EXPECT_EQ(rule.toString(), "B2/S345/C4");    // unchanged after a failed parse
+}
+
+// =========================================================
+// Test Grid: verify stepRule with B3/S23 matches stepClassicRules
+// =========================================================
+TEST(GridTest, StepRuleMatchesClassic) {
+    Grid classic, generic;
+    classic.loadFromFile("../input/wikipedia_test.pbm");
+    generic.loadFromFile("../input/wikipedia_test.pbm");
+    Rule life;
+
+    for (int step = 0; step < 10; ++step) {
+        classic.stepClassicRules(true);
+        generic.stepRule(life, true);
+    }
+    ASSERT_EQ(generic.getWidth(), classic.getWidth());
+    ASSERT_EQ(generic.getHeight(), classic.getHeight());
+    EXPECT_EQ(generic.extractRegion(0, 0, 80, 20), classic.extractRegion(0, 0, 80, 20));
+    EXPECT_EQ(generic.getPopulation(), classic.getPopulation());
+}
+
+// =========================================================
+// Test Grid: verify Generations rules decay cells through the dying states
+// =========================================================
+TEST(GridTest, StepRuleGenerationsDecay) {
+    Rule starWars;
+    ASSERT_TRUE(starWars.parse("345/2/4"));
+    Grid grid(5, 5);
+    grid.at(2, 2).setAlive(true);
+
+    grid.stepRule(starWars, false);
+    EXPECT_EQ(grid.at(2, 2).getState(), 2);       // lonely cell starts dying
+    EXPECT_EQ(grid.getDeaths(), 1);
+    grid.stepRule(starWars, false);
+    EXPECT_EQ(grid.at(2, 2).getState(), 3);
+    grid.stepRule(starWars, false);
+    EXPECT_EQ(grid.at(2, 2).getState(), 0);       // dead after the last state
+
+    // Brian's Brain: two live cells give birth to the cells next to both of them
+    Rule brain;
+    ASSERT_TRUE(brain.parse("B2/S/C3"));
+    Grid pair(4, 3);
+    pair.at(1, 1).setAlive(true);
+    pair.at(2, 1).setAlive(true);
+    pair.stepRule(brain, false);
+    EXPECT_EQ(pair.at(1, 1).getState(), 2);
+    EXPECT_EQ(pair.at(2, 1).getState(), 2);
+    EXPECT_TRUE(pair.at(1, 0).isAliveNow());
+    EXPECT_TRUE(pair.at(2, 0).isAliveNow());
+    EXPECT_TRUE(pair.at(1, 2).isAliveNow());
+    EXPECT_TRUE(pair.at(2, 2).isAliveNow());
+    EXPECT_EQ(pair.getPopulation(), 4);
+}
+
+// =========================================================
+// Test Grid: verify multi-state grids survive a PGM round-trip
+// =========================================================
+TEST(GridTest, SaveLoadPgmKeepsStates) {
+    const std::string path = "../output/states_test.pgm";
+    Rule brain;
+    ASSERT_TRUE(brain.parse("B2/S/C3"));
+    Grid grid;
+    grid.randomInit(30, 20, 0.3, 5);
+    grid.stepRule(brain, false);
+    ASSERT_TRUE(grid.saveToFile(path));
+
+    Grid loaded;
+    ASSERT_TRUE(loaded.loadFromFile(path));
+    ASSERT_EQ(loaded.getWidth(), grid.getWidth());
+    ASSERT_EQ(loaded.getHeight(), grid.getHeight());
+    int dying = 0;
+    for (int y = 0; y < grid.getHeight(); ++y) {
+        for (int x = 0; x < grid.getWidth(); ++x) {
+            EXPECT_EQ(loaded.at(x, y).getState(), grid.at(x, y).getState());
+            dying += grid.at(x, y).getState() == 2;
+        }
+    }
+    EXPECT_GT(dying, 0);
+    EXPECT_EQ(loaded.getPopulation(), grid.getPopulation());
+    std::remove(path.c_str());
+}
+
+
+// Reference Larger than Life step: counts every neighbourhood cell one by one
+static std::vector<std::vector<bool>> naiveLargerThanLife(const Grid& grid, int r, bool vonNeumann,
+                                                          bool center, int sMin, int sMax,
+                                                          int bMin, int bMax) {
+    std::vector<std::vector<bool>> next(grid.getWidth(), std::vector<bool>(grid.getHeight()));
+    for (int x = 0; x < grid.getWidth(); ++x) {
+        for (int y = 0; y < grid.getHeight(); ++y) {
+            int count = 0;
+            for (int dx = -r; dx <= r; ++dx) {
+                for (int dy = -r; dy <= r; ++dy) {
+                    if (vonNeumann && std::abs(dx) + std::abs(dy) > r) continue;
+                    if (!center && dx == 0 && dy == 0) continue;
+                    if (grid.isInside(x + dx, y + dy) && grid.at(x + dx, y + dy).isAliveNow()) count++;
+                }
+            }
+            bool alive = grid.at(x, y).isAliveNow();
+            next[x][y] = alive ? (count >= sMin && count <= sMax) : (count >= bMin && count <= bMax);
+        }
+    }
+    return next;
+}
+
+// =========================================================
+// Test Rule: verify parsing of Larger than Life notation
+// =========================================================
+TEST(RuleTest, ParseLargerThanLife) {
+    Rule bosco;
+    ASSERT_TRUE(bosco.parse("R5,C0,M1,S34..58,B34..45,NM"));
+    EXPECT_TRUE(bosco.isLargerThanLife());
+    EXPECT_EQ(bosco.getRange(), 5);
+    EXPECT_TRUE(bosco.includesCenter());
+    EXPECT_EQ(bosco.getNeighborhood(), Rule::Neighborhood::Moore);
+    EXPECT_TRUE(bosco.isBirth(34));
+    EXPECT_FALSE(bosco.isBirth(46));
+    EXPECT_TRUE(bosco.isSurvival(58));
+    EXPECT_EQ(bosco.toString(), "R5,C0,M1,S34..58,B34..45,NM");
+
+    Rule diamond;
+    ASSERT_TRUE(diamond.parse("R2,S3..5,B4..4,NN"));
+    EXPECT_EQ(diamond.getNeighborhood(), Rule::Neighborhood::VonNeumann);
+    EXPECT_FALSE(diamond.includesCenter());
+
+    EXPECT_FALSE(diamond.parse("R0,S3..5,B4..4"));
+    EXPECT_FALSE(diamond.parse("R20000,S3..5,B4..4"));   // beyond the range limit
+    EXPECT_FALSE(diamond.parse("R2,S5..3,B4..4"));
+    EXPECT_FALSE(diamond.parse("R2,B4..4"));
+}
+
+// =========================================================
+// Test Grid: verify the Larger than Life kernel against a naive count
+// =========================================================
+TEST(GridTest, LargerThanLifeMatchesNaiveCount) {
+    const char* specs[] = {
+        "R3,C0,M0,S8..14,B9..12,NM",
+        "R3,C0,M1,S5..9,B6..8,NN",
+        "R1,C0,M0,S2..3,B3..3,NN",
+        "R5,C0,M1,S34..58,B34..45,NM",
+    };
+    for (const char* spec : specs) {
+        Rule rule;
+        ASSERT_TRUE(rule.parse(spec));
+        Grid grid;
+        grid.randomInit(37, 29, 0.4, 11);
+
+        bool vonNeumann = rule.getNeighborhood() == Rule::Neighborhood::VonNeumann;
+        int sMin = 0, sMax = 0, bMin = 0, bMax = 0;
+        for (int n = 0; n < 200; ++n) {
+            if (rule.isSurvival(n)) { if (!sMax) sMin = n; sMax = n; }
+            if (rule.isBirth(n)) { if (!bMax) bMin = n; bMax = n; }
+        }
+        auto expected = naiveLargerThanLife(grid, rule.getRange(), vonNeumann,
+                                            rule.includesCenter(), sMin, sMax, bMin, bMax);
+
+        grid.stepLargerThanLife(rule, false, 3);
+        for (int x = 0; x < grid.getWidth(); ++x) {
+            for (int y = 0; y < grid.getHeight(); ++y) {
+                ASSERT_EQ(grid.at(x, y).isAliveNow(), expected[x][y])
+                    << spec << " mismatch at (" << x << "," << y << ")";
+            }
+        }
+    }
+}
+
+// =========================================================
+// Test Grid: verify range-1 Larger than Life reproduces Conway's rule
+// =========================================================
+TEST(GridTest, LargerThanLifeRangeOneIsLife) {
+    Rule life;
+    ASSERT_TRUE(life.parse("R1,C0,M0,S2..3,B3..3,NM"));
+    Grid classic, ltl;
+    classic.loadFromFile("../input/glider_test.pbm");
+    ltl.loadFromFile("../input/glider_test.pbm");
+    for (int step = 0; step < 12; ++step) {
+        classic.stepClassicRules(true);
+        ltl.stepRule(life, true);
+    }
+    EXPECT_EQ(ltl.getPopulation(), 5);
+    EXPECT_EQ(ltl.extractRegion(-20, -20, 40, 40), classic.extractRegion(-20, -20, 40, 40));
+}
+
+
+// Builds a bitmap from rows of 'o' (alive) and '.' (dead)
+static Bitmap patternOf(const std::vector<std::string>& rows) {
+    Bitmap bits(static_cast<int>(rows[0].size()), static_cast<int>(rows.size()));
+    for (std::size_t y = 0; y < rows.size(); y++) {
+        for (std::size_t x = 0; x < rows[y].size(); x++) {
+            bits.set(static_cast<int>(x), static_cast<int>(y), rows[y][x] == 'o');
+        }
+    }
+    return bits;
+}
+
+// =========================================================
+// Test Census: verify known objects are classified in any orientation
+// =========================================================
+TEST(CensusTest, ClassifiesKnownObjects) {
+    Grid grid(140, 40);
+    grid.applyPatch(patternOf({"oo", "oo"}), 2, 2);
+    grid.applyPatch(patternOf({"oo", "oo"}), 10, 2);
+    grid.applyPatch(patternOf({"ooo"}), 62, 2);                    // run across a word boundary
+    grid.applyPatch(patternOf({"o", "o", "o"}), 20, 20);
+    grid.applyPatch(patternOf({".o.", "..o", "ooo"}), 30, 2);
+    grid.applyPatch(patternOf({"o.o", "oo.", ".o."}), 40, 20);     // other glider phase, mirrored
+    grid.applyPatch(patternOf({".o.", "o.o", "oo."}), 100, 30);    // boat, rotated
+    grid.applyPatch(patternOf({".oo.", "o..o", "o..o", ".oo."}), 120, 10);
+    grid.applyPatch(patternOf({"..o.", "o..o", "o..o", ".o.."}), 80, 30);   // toad, second phase
+    grid.applyPatch(patternOf({"oo.o", "o.oo", "...."}), 2, 30);   // snake
+    grid.applyPatch(patternOf({"oooo", "o..."}), 50, 30);          // unknown
+
+    Census census(2, 3);
+    census.take(grid);
+    EXPECT_EQ(census.getObjectCount(), 11);
+    EXPECT_EQ(census.getCount("block"), 2);
+    EXPECT_EQ(census.getCount("blinker"), 2);
+    EXPECT_EQ(census.getCount("glider"), 2);
+    EXPECT_EQ(census.getCount("boat"), 1);
+    EXPECT_EQ(census.getCount("pond"), 1);
+    EXPECT_EQ(census.getCount("toad"), 1);
+    EXPECT_EQ(census.getCount("snake"), 1);
+    int unknown = 0;
+    for (const auto& entry : census.getCounts()) {
+        if (entry.first.rfind("unknown_5_", 0) == 0) unknown += entry.second;
+    }
+    EXPECT_EQ(unknown, 1);
+
+    // with distance 1 the second toad phase splits into two pieces
+    Census adjacent(1, 1);
+    adjacent.take(grid);
+    EXPECT_EQ(adjacent.getObjectCount(), 12);
+    EXPECT_EQ(adjacent.getCount("toad"), 0);
+}
+
+// =========================================================
+// Test Census: verify a settled soup gives the same census for any thread count
+// =========================================================
+TEST(CensusTest, SettledSoupIndependentOfThreads) {
+    Grid grid;
+    grid.randomInit(200, 200, 0.35, 17);
+    for (int i = 0; i < 300; i++) grid.stepClassicRules(false);
+
+    Census single(2, 1);
+    single.take(grid);
+    Census parallel(2, 7);
+    parallel.take(grid);
+    EXPECT_EQ(single.getCounts(), parallel.getCounts());
+    EXPECT_GT(single.getCount("block"), 0);
+    EXPECT_GT(single.getCount("blinker"), 0);
+}
+
+// Writes a grid as a binary PBM (P4) file
+static void writeP4(const std::string& path, const Grid& grid) {
+    std::ofstream file(path, std::ios::binary);
+    file << "P4\n# test board\n" << grid.getWidth() << " " << grid.getHeight() << "\n";
+    for (int y = 0; y < grid.getHeight(); y++) {
+        std::vector<char> bytes((grid.getWidth() + 7) / 8, 0);
+        for (int x = 0; x < grid.getWidth(); x++) {
+            if (grid.at(x, y).isAliveNow()) bytes[x / 8] |= static_cast<char>(0x80 >> (x % 8));
+        }
+        file.write(bytes.data(), bytes.size());
+    }
+}
+
+// =========================================================
+// Test StreamStepper: verify streamed passes match in-memory stepping
+// =========================================================
+TEST(StreamStepperTest, MatchesInMemoryStepping) {
+    const std::string input = "../output/stream_in.pbm";
+    const std::string output = "../output/stream_out.pbm";
+    Grid grid;
+    grid.randomInit(150, 97, 0.4, 21);
+    writeP4(input, grid);
+
+    Grid loaded;
+    ASSERT_TRUE(loaded.loadFromFile(input));
+    EXPECT_EQ(loaded.extractRegion(0, 0, 150, 97), grid.extractRegion(0, 0, 150, 97));
+
+    Rule rule;
+    ASSERT_TRUE(rule.parse("B36/S23"));
+    StreamStepper stepper;
+    ASSERT_TRUE(stepper.setRule(rule));
+    stepper.setStripHeight(8);
+    stepper.setGenerationsPerPass(3);
+    ASSERT_TRUE(stepper.run(input, output, 7));   // passes of 3, 3 and 1 generations
+
+    for (int i = 0; i < 7; i++) grid.stepRule(rule, false);
+    Grid streamed;
+    ASSERT_TRUE(streamed.loadFromFile(output));
+    EXPECT_EQ(streamed.getWidth(), 150);
+    EXPECT_EQ(streamed.getHeight(), 97);
+    EXPECT_EQ(streamed.extractRegion(0, 0, 150, 97), grid.extractRegion(0, 0, 150, 97));
+
+    Rule brain;
+    ASSERT_TRUE(brain.parse("B2/S/C3"));
+    EXPECT_FALSE(stepper.setRule(brain));
+    EXPECT_FALSE(stepper.run("../output/missing.pbm", output, 1));
+
+    // the input is never overwritten, not even through a temporary file
+    EXPECT_FALSE(stepper.run(input, input, 1));
+    writeP4(output + ".pass1", loaded);
+    EXPECT_FALSE(stepper.run(output + ".pass1", output, 1));
+    Grid unchanged;
+    ASSERT_TRUE(unchanged.loadFromFile(input));
+    EXPECT_EQ(unchanged.getPopulation(), loaded.getPopulation());
+    ASSERT_TRUE(unchanged.loadFromFile(output + ".pass1"));
+    EXPECT_EQ(unchanged.getPopulation(), loaded.getPopulation());
+    std::remove((output + ".pass1").c_str());
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
 // =========================================================
 // Test Game: verify Game::run applies correct number of steps
 // =========================================================
@@ -183,6 +777,148 @@ TEST(GameTest, RunSimulationWikipedia) {
     }
 }
 
+// =========================================================
+// Test Game: verify generation counter and stats file output
+// =========================================================
+TEST(GameTest, StatsFileOneLinePerGeneration) {
+    const std::string path = "../output/stats_test.csv";
+    std::remove(path.c_str());
+
+    Grid initial;
+    initial.loadFromFile("../input/next_state_test.pbm");
+    Game game(initial);
+    game.setSteps(4);
+    game.setDelay(0);
+    game.setStatsFile(path);
+    game.run(false);
+
+    EXPECT_EQ(game.getGeneration(), 4);
+    EXPECT_EQ(game.getPopulation(), initial.getPopulation());
+
+    std::ifstream file(path);
+    ASSERT_TRUE(file.is_open());
+    std::string line;
+    int lines = 0;
+    while (std::getline(file, line)) lines++;
+    EXPECT_EQ(lines, 1 + 5);  // header + generations 0..4
+    std::remove(path.c_str());
+}
+
+// =========================================================
+// Test Game: verify seek and rewind restore recorded generations
+// =========================================================
+TEST(GameTest, HistorySeekAndRewind) {
+    Grid initial;
+    initial.randomInit(60, 40, 0.35, 3);
+
+    // reference run, one snapshot per generation
+    std::vector<Grid> snapshots{initial};
+    Grid reference = initial;
+    for (int step = 0; step < 50; ++step) {
+        reference.stepClassicRules();
+        snapshots.push_back(reference);
+    }
+
+    Game game(initial);
+    game.setHistoryBudget(std::size_t(16) << 20, 8);
+    game.setSteps(50);
+    game.setDelay(0);
+    game.run(false);
+    EXPECT_EQ(game.getHistory().getOldestGeneration(), 0);
+    EXPECT_EQ(game.getHistory().getNewestGeneration(), 50);
+
+    for (int gen : {0, 7, 8, 9, 33, 50, 21}) {
+        ASSERT_TRUE(game.seek(gen));
+        const Grid& expected = snapshots[gen];
+        const Grid& grid = game.getGrid();
+        EXPECT_EQ(game.getGeneration(), gen);
+        ASSERT_EQ(grid.getWidth(), expected.getWidth()) << "generation " << gen;
+        ASSERT_EQ(grid.getHeight(), expected.getHeight());
+        EXPECT_EQ(grid.getOriginX(), expected.getOriginX());
+        EXPECT_EQ(grid.getOriginY(), expected.getOriginY());
+        EXPECT_EQ(grid.extractRegion(-100, -100, 300, 300), expected.extractRegion(-100, -100, 300, 300));
+        EXPECT_EQ(grid.getPopulation(), expected.getPopulation());
+    }
+
+    // continue from generation 21 after rewinding: the old future is replaced
+    ASSERT_TRUE(game.rewind(1));
+    EXPECT_EQ(game.getGeneration(), 20);
+    game.setSteps(5);
+    game.run(false);
+    EXPECT_EQ(game.getGeneration(), 25);
+    EXPECT_EQ(game.getHistory().getNewestGeneration(), 25);
+    EXPECT_EQ(game.getGrid().extractRegion(-100, -100, 300, 300),
+              snapshots[25].extractRegion(-100, -100, 300, 300));
+    EXPECT_FALSE(game.seek(26));
+}
+
+// =========================================================
+// Test Game: verify seeking restores the dying states of a Generations rule
+// =========================================================
+TEST(GameTest, HistoryKeepsGenerationsStates) {
+    Rule rule;
+    ASSERT_TRUE(rule.parse("B2/S/C5"));
+    Grid initial;
+    initial.randomInit(40, 40, 0.3, 5);
+
+    std::vector<Grid> snapshots{initial};
+    Grid reference = initial;
+    for (int step = 0; step < 10; ++step) {
+        reference.stepRule(rule);
+        snapshots.push_back(reference);
+    }
+
+    auto expectSameStates = [](const Grid& grid, const Grid& expected) {
+        ASSERT_EQ(grid.getWidth(), expected.getWidth());
+        ASSERT_EQ(grid.getHeight(), expected.getHeight());
+        EXPECT_EQ(grid.getOriginX(), expected.getOriginX());
+        EXPECT_EQ(grid.getOriginY(), expected.getOriginY());
+        EXPECT_EQ(grid.getPopulation(), expected.getPopulation());
+        for (int x = 0; x < grid.getWidth(); x++) {
+            for (int y = 0; y < grid.getHeight(); y++) {
+                ASSERT_EQ(grid.at(x, y).getState(), expected.at(x, y).getState()) << x << "," << y;
+            }
+        }
+    };
+
+    Game game(initial);
+    game.setRule(rule);
+    game.setHistoryBudget(std::size_t(16) << 20, 4);
+    game.setSteps(10);
+    game.setDelay(0);
+    game.run(false);
+
+    for (int gen : {3, 4, 5, 10}) {
+        ASSERT_TRUE(game.seek(gen));
+        expectSameStates(game.getGrid(), snapshots[gen]);
+    }
+    ASSERT_TRUE(game.seek(5));
+    game.setSteps(5);
+    game.run(false);
+    expectSameStates(game.getGrid(), snapshots[10]);
+}
+
+// =========================================================
+// Test Game: verify the history drops old generations beyond its budget
+// =========================================================
+TEST(GameTest, HistoryRespectsMemoryBudget) {
+    Grid initial;
+    initial.randomInit(100, 100, 0.3, 9);
+    Game game(initial);
+    game.setHistoryBudget(32 * 1024, 16);
+    game.setSteps(200);
+    game.setDelay(0);
+    game.run(false);
+
+    const History& history = game.getHistory();
+    EXPECT_EQ(history.getNewestGeneration(), 200);
+    EXPECT_GT(history.getOldestGeneration(), 0);
+    EXPECT_EQ(history.getOldestGeneration() % 16, 0);   // groups start at a keyframe
+    EXPECT_LE(history.getMemoryUsage(), std::size_t(32 * 1024));
+    EXPECT_FALSE(game.seek(0));
+    EXPECT_TRUE(game.seek(history.getOldestGeneration()));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();